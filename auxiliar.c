@@ -2,8 +2,26 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
+#include <ctype.h>
 #include "auxiliar.h"
 #include "bignumber.h"
+#include "budget.h"
+#include "storage.h"
+#include "thread_pool.h"
+#include "tuning.h"
+
+
+static char* read_line(FILE *input, size_t max_length, bool *is_too_long);
+static bool is_statement_line(char *line);
+static void execute_statements(char *line, RegisterTable table, FILE *output);
+static bool is_partial_result_command(char *command);
+static void execute_partial_result_command(char *command, Connection connection);
+static void execute_multiple_operands_command(char *command, Connection connection);
+static RegisterTable create_register_table();
+static void free_register_table(RegisterTable table);
+static BigNumber multiply_product_tree(long long *factors, int begin, int end);
+static void multiply_product_subtree(void *context, int index);
 
 
 /*
@@ -17,92 +35,313 @@
 */
 
 char* read_input() {
-    int capacity = 16;
-    int size = 0;
-    char* input = malloc(capacity);
+    return read_line(stdin, 0, NULL);
+}
+
+
+/*
+* @brief Lê uma linha de um arquivo.
+*
+* @param input Arquivo de onde a linha será lida.
+* @param max_length Tamanho máximo da linha (0 para não ter limite).
+* @param is_too_long Ponteiro que indica se a linha passou do limite (pode ser NULL).
+*
+* @details Funciona como read_input(), mas para qualquer arquivo. Se a linha passar do
+*          tamanho máximo, a leitura é interrompida e o conteúdo lido até ali é retornado.
+*
+* @return char* Ponteiro para a string alocada dinamicamente contendo a linha lida.
+*/
+
+static char* read_line(FILE *input, size_t max_length, bool *is_too_long) {
+    size_t capacity = 16;
+    size_t size = 0;
+    char* line = malloc(capacity);
 
     int c;
 
-    while ((c = getchar()) != EOF && c != '\n') {
-        input[size] = c;
+    if (is_too_long != NULL) *is_too_long = false;
+
+    while ((c = getc(input)) != EOF && c != '\n') {
+        if (max_length > 0 && size >= max_length) {
+            if (is_too_long != NULL) *is_too_long = true;
+            break;
+        }
+
+        line[size] = c;
         size++;
 
         if (size + 1 >= capacity) {
             capacity *= 2;
 
-            char* new_input = realloc(input, capacity);
-            input = new_input;
+            char* new_line = realloc(line, capacity);
+            line = new_line;
         }
     }
 
-    input[size] = '\0';
+    line[size] = '\0';
+
+    return line;
+}
+
+
+/*
+* @brief Cria uma conexão, que agrupa a entrada e a saída de uma execução do programa.
+*
+* @param input Arquivo de onde as requisições são lidas.
+* @param output Arquivo onde as respostas são escritas.
+* @param max_line_length Tamanho máximo de cada linha (0 para não ter limite).
+* @param flush_each_response Se verdadeiro, a saída é descarregada após cada resposta.
+*
+* @return A conexão criada.
+*/
+
+Connection create_connection(FILE *input, FILE *output, size_t max_line_length, bool flush_each_response) {
+    Connection connection = (Connection)malloc(sizeof(struct Connection));
+
+    connection->input = input;
+    connection->output = output;
+    connection->max_line_length = max_line_length;
+    connection->flush_each_response = flush_each_response;
+    connection->has_failed = false;
+
+    return connection;
+}
+
+
+/*
+* @brief Lê uma linha de uma conexão.
+*
+* @param connection Conexão de onde a linha será lida.
+*
+* @details Se a linha passar do limite da conexão, ela é marcada como falha, para que
+*          execute_connection() encerre a execução depois da requisição atual.
+*
+* @return char* Ponteiro para a string alocada dinamicamente contendo a linha lida.
+*/
+
+static char* read_connection_line(Connection connection) {
+    bool is_too_long;
+    char* line = read_line(connection->input, connection->max_line_length, &is_too_long);
+
+    if (is_too_long) connection->has_failed = true;
 
-    return input;
+    return line;
 }
 
 
 /*
 * @brief Executa o programa.
 *
-* @details Aqui é usado a função read_input() pra alocar dinamicamente
-*          as strings fornecidas dos Big Numbers e das operações.
-*          Se observado que não há mais números sendo fornecidos para as operações,
-*          o programa para.
+* @details Lê as requisições da entrada padrão e escreve as respostas na saída padrão,
+*          sem limite de tamanho de linha. Veja execute_connection().
 */
 
 void execute_program() {
+    Connection connection = create_connection(stdin, stdout, 0, false);
+
+    execute_connection(connection);
+
+    free(connection);
+}
+
+
+/*
+* @brief Executa as requisições de uma conexão.
+*
+* @param connection Conexão de onde as requisições são lidas e para onde as respostas vão.
+*
+* @details Aqui é usado a função read_connection_line() pra alocar dinamicamente
+*          as strings fornecidas dos Big Numbers e das operações.
+*          Uma linha começando com "sum k" ou "dot k" inicia um comando de múltiplos
+*          operandos, uma linha "digits op", "leading k op" ou "trailing k op" pede só uma
+*          parte do resultado de "x op y", e uma linha com atribuições ou "print" é executada
+*          no modo de registradores, que mantém os valores entre as linhas da mesma conexão. Se observado
+*          que não há mais números sendo fornecidos para as operações, ou se alguma linha passar
+*          do limite da conexão, a execução para.
+*/
+
+void execute_connection(Connection connection) {
+    RegisterTable registers = create_register_table();
+    FILE* output = connection->output;
+
     while(1) {
-        char* number_1 = read_input();
+        char* number_1 = read_connection_line(connection);
 
         if (strlen(number_1) == 0) {
             free(number_1);
             break;
         }
 
-        char* number_2 = read_input();
-        char* operation = read_input();
+        if (connection->has_failed) {
+            free(number_1);
+        }
 
-        BigNumber big_num1 = create_big_number(number_1);
-        BigNumber big_num2 = create_big_number(number_2);
-        BigNumber result = NULL;
+        else if (is_statement_line(number_1)) {
+            execute_statements(number_1, registers, output);
+            free(number_1);
+        }
+
+        else if (is_partial_result_command(number_1)) {
+            execute_partial_result_command(number_1, connection);
+            free(number_1);
+        }
+
+        else if (isalpha((unsigned char) number_1[0])) {
+            execute_multiple_operands_command(number_1, connection);
+            free(number_1);
+        }
+
+        else {
+            char* number_2 = read_connection_line(connection);
+            char* operation = read_connection_line(connection);
+
+            BigNumber big_num1 = create_big_number(number_1);
+            BigNumber big_num2 = create_big_number(number_2);
+
+            const char* error = NULL;
+            BigNumber result = connection->has_failed ? NULL : apply_operation(find_operation(operation), big_num1, big_num2, &error);
+
+            if (result != NULL) {
+                fprint_big_number(output, result);
+                free_big_number(result);
+            }
 
-        switch (*operation) {
-            case '+':
-                result = sum_big_numbers(big_num1, big_num2);
-                break;
-            case '-':
-                result = subtract_big_numbers(big_num1, big_num2);
-                break;
-            case '/':
-                result = divide_big_numbers(big_num1, big_num2);
-                break;
-            case '*':
-                result = multiply_karatsuba_big_numbers(big_num1, big_num2);
-                break;
-            case '%':
-                result = remainder_of_division(big_num1, big_num2);
-                break;
-            case '^':
-                result = fast_exponentiation(big_num1, big_num2);
-                break;
-            case 'x':
-                result = multiply_big_numbers(big_num1, big_num2);
-                break;
-            default:
-                printf("Operação não conhecida");
-                result = create_big_number("");
-                break;
+            else if (!connection->has_failed) {
+                fprintf(output, "%s\n", error);
+            }
+
+            free_big_number(big_num1);
+            free_big_number(big_num2);
+            free(number_1);
+            free(number_2);
+            free(operation);
+        }
+
+        if (connection->has_failed) {
+            fprintf(output, "Linha longa demais\n");
+            fflush(output);
+            break;
         }
 
-        print_big_number(result);
+        if (connection->flush_each_response) fflush(output);
+    }
+
+    free_register_table(registers);
+}
+
+
+/*
+* @brief Encontra o caractere de uma operação a partir do texto lido.
+*
+* @param operation Texto da operação.
+*
+* @details As operações com nome ("divexact", divisão exata) são convertidas para o
+*          caractere usado por apply_operation() ('E'); nas demais, vale o primeiro caractere.
+*
+* @return Caractere que identifica a operação.
+*/
+
+char find_operation(const char *operation) {
+    if (strcmp(operation, "divexact") == 0) return 'E';
+
+    return *operation;
+}
+
+
+/*
+* @brief Aplica uma operação binária entre dois Big Numbers.
+*
+* @param operation Caractere que identifica a operação.
+* @param x Primeiro operando.
+* @param y Segundo operando (ignorado pelo fatorial).
+* @param error Ponteiro onde a mensagem de erro será armazenada, se houver.
+*
+* @details Além das operações aritméticas básicas, aceita '!' (fatorial de x),
+*          'C' (binomial), 'P' (produto do intervalo [x, y]) e 'E' (divisão exata, quando x
+*          é sabidamente múltiplo de y). Antes de executar, o tamanho
+*          e o custo do resultado são estimados e comparados com os limites da requisição;
+*          durante a execução, os algoritmos demorados verificam o prazo e são interrompidos
+*          se ele passar. Algumas operações alteram o sinal dos operandos durante o cálculo,
+*          então os sinais originais são restaurados no final, permitindo reutilizar os
+*          operandos (como nos registradores).
+*
+* @return Big Number resultado da operação, ou NULL em caso de erro, de limite excedido
+*         ou de cancelamento.
+*/
+
+BigNumber apply_operation(char operation, BigNumber x, BigNumber y, const char **error) {
+    bool sign_x = x->is_positive;
+    bool sign_y = y->is_positive;
+
+    BigNumber result = NULL;
+    *error = "Entrada inválida";
+
+    if (x->num_digits == 0 || (y->num_digits == 0 && operation != '!') || (operation == '^' && !y->is_positive)) {
+        return NULL;
+    }
+
+    const char* budget_error = check_budget(operation, x, y);
+
+    if (budget_error != NULL) {
+        *error = budget_error;
+        return NULL;
+    }
+
+    struct RequestState request;
+    begin_request(&request, bignumber_budget.max_seconds);
+
+    switch (operation) {
+        case '+':
+            result = sum_big_numbers(x, y);
+            break;
+        case '-':
+            result = subtract_big_numbers(x, y);
+            break;
+        case '/':
+            result = divide_big_numbers(x, y);
+            break;
+        case 'E':
+            result = divexact_big_numbers(x, y);
+            if (result == NULL && !(y->num_digits == 1 && y->first_digit->digit == 0)) *error = "Divisão não exata";
+            break;
+        case '*':
+            result = multiply_karatsuba_big_numbers(x, y);
+            break;
+        case '%':
+            result = remainder_of_division(x, y);
+            break;
+        case '^':
+            result = fast_exponentiation(x, y);
+            break;
+        case 'x':
+            result = multiply_big_numbers(x, y);
+            break;
+        case '!':
+            result = factorial_big_number(x);
+            break;
+        case 'C':
+            result = binomial_big_numbers(x, y);
+            break;
+        case 'P':
+            result = product_of_range(x, y);
+            break;
+        default:
+            *error = "Operação não conhecida";
+            break;
+    }
+
+    end_request();
 
-        free_big_number(big_num1);
-        free_big_number(big_num2);
+    if (request.is_cancelled && result != NULL) {
         free_big_number(result);
-        free(number_1);
-        free(number_2);
-        free(operation);
+        result = NULL;
+        *error = "Tempo limite excedido";
     }
+
+    x->is_positive = sign_x;
+    y->is_positive = sign_y;
+
+    return result;
 }
 
 
@@ -118,7 +357,7 @@ void execute_program() {
 */
 
 Node create_node(int digit) {
-    Node new_node = (Node)malloc(sizeof(struct Node));
+    Node new_node = allocate_node();
 
     new_node->digit = digit;
     new_node->next_digit = NULL;
@@ -140,7 +379,7 @@ Node create_node(int digit) {
 */
 
 void add_node_to_big_number(BigNumber big_number, int digit, bool insert_at_end) {
-    Node new_node = (Node)malloc(sizeof(struct Node));
+    Node new_node = allocate_node();
 
     if (!insert_at_end) {
         new_node->digit = digit;
@@ -221,7 +460,7 @@ int compare_big_numbers_modules(BigNumber x, BigNumber y) {
 *          sem alterar o número original.
 */
 
-void copy_big_number(BigNumber big_number_dest, BigNumber big_number_orig, int tam, bool by_end_of_orig) {
+static void copy_big_number(BigNumber big_number_dest, BigNumber big_number_orig, int tam, bool by_end_of_orig) {
     if (!by_end_of_orig) {
         Node node_to_cpy = big_number_orig->first_digit;
 
@@ -260,7 +499,7 @@ void remove_zeros_from_left(BigNumber big_number) {
         big_number->first_digit = node_to_remove->next_digit;
         big_number->first_digit->prev_digit = NULL;
 
-        free(node_to_remove);
+        release_node(node_to_remove);
         big_number->num_digits--;
     }
 
@@ -424,4 +663,887 @@ BigNumber get_remainder_by_power_of_ten(BigNumber x, int power) {
     result->num_digits = power;
 
     return result;
-}
\ No newline at end of file
+}
+
+/*
+* @brief Cria um Big Number a partir de um inteiro nativo.
+*
+* @param value Valor a ser convertido.
+*
+* @return Big Number equivalente ao valor fornecido.
+*/
+
+static BigNumber create_big_number_from_long(long long value) {
+    char str_number[32];
+
+    sprintf(str_number, "%lld", value);
+
+    return create_big_number(str_number);
+}
+
+
+/*
+* @brief Converte um Big Number para um inteiro nativo.
+*
+* @param x Big Number a ser convertido.
+* @param value Ponteiro onde o valor convertido será armazenado.
+*
+* @details A conversão só é feita se o módulo do Big Number couber em um long long,
+*          caso contrário, a função retorna falso e "value" não é alterado.
+*
+* @return true, se a conversão foi possível.
+* @return false, caso contrário.
+*/
+
+bool big_number_to_long(BigNumber x, long long *value) {
+    if (x->num_digits == 0 || x->num_digits > 18) return false;
+
+    long long converted = 0;
+
+    for (Node node = x->first_digit; node != NULL; node = node->next_digit) {
+        converted = converted * 10 + node->digit;
+    }
+
+    *value = (x->is_positive) ? converted : -converted;
+
+    return true;
+}
+
+
+/*
+* @brief Lista os números primos até um limite.
+*
+* @param limit Maior valor a ser considerado.
+* @param count Ponteiro onde a quantidade de primos encontrados será armazenada.
+*
+* @details Utiliza o crivo de Eratóstenes. O vetor retornado é alocado dinamicamente
+*          e deve ser liberado com free().
+*
+* @return long long* Vetor com os primos em ordem crescente.
+*/
+
+long long* list_primes_up_to(long long limit, int *count) {
+    *count = 0;
+
+    if (limit < 2) return malloc(sizeof(long long));
+
+    char* is_composite = calloc(limit + 1, sizeof(char));
+    long long* primes = malloc(sizeof(long long) * (limit / 2 + 2));
+
+    for (long long i = 2; i <= limit; i++) {
+        if (is_composite[i]) continue;
+
+        primes[(*count)++] = i;
+
+        for (long long j = i * i; j <= limit; j += i) {
+            is_composite[j] = 1;
+        }
+    }
+
+    free(is_composite);
+
+    return primes;
+}
+
+
+/*
+* @brief Multiplica uma lista de fatores utilizando uma árvore de produtos balanceada.
+*
+* @param factors Vetor de fatores positivos.
+* @param count Quantidade de fatores.
+*
+* @details Primeiro, fatores consecutivos são agrupados enquanto o produto couber em um
+*          long long, evitando criar Big Numbers para valores pequenos. Depois, os grupos
+*          são multiplicados dois a dois de forma recursiva, de modo que cada multiplicação
+*          envolva operandos de tamanhos parecidos, aproveitando melhor o Karatsuba.
+*          O vetor "factors" é reaproveitado para os agrupamentos.
+*
+* @return Big Number produto de todos os fatores (1 se a lista for vazia).
+*/
+
+BigNumber multiply_list_of_factors(long long *factors, int count) {
+    int groups = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (groups > 0 && factors[groups - 1] <= LLONG_MAX / factors[i]) {
+            factors[groups - 1] *= factors[i];
+        }
+
+        else {
+            factors[groups++] = factors[i];
+        }
+    }
+
+    if (groups == 0) return create_big_number("1");
+
+    return multiply_product_tree(factors, 0, groups);
+}
+
+
+/*
+* @brief Multiplica recursivamente os fatores do intervalo [begin, end).
+*
+* @param factors Vetor de fatores.
+* @param begin Índice inicial (inclusivo).
+* @param end Índice final (exclusivo).
+*
+* @details As duas metades da árvore são independentes; quando o intervalo tem pelo menos
+*          PRODUCT_TREE_PARALLEL_LEAVES fatores e o produto pode ter pelo menos
+*          bignumber_thresholds.parallel dígitos (até 19 por fator), elas são calculadas em threads diferentes.
+*
+* @return Big Number produto dos fatores do intervalo.
+*/
+
+static BigNumber multiply_product_tree(long long *factors, int begin, int end) {
+    if (end - begin == 1 || is_request_cancelled()) return create_big_number_from_long(factors[begin]);
+
+    int middle = begin + (end - begin) / 2;
+
+    ProductSubtrees subtrees = {factors, {begin, middle}, {middle, end}, {NULL, NULL}};
+
+    if (end - begin >= PRODUCT_TREE_PARALLEL_LEAVES && 19.0 * (end - begin) >= bignumber_thresholds.parallel) {
+        bignumber_parallel_for(multiply_product_subtree, &subtrees, 2);
+    }
+
+    else {
+        multiply_product_subtree(&subtrees, 0);
+        multiply_product_subtree(&subtrees, 1);
+    }
+
+    BigNumber result = multiply_karatsuba_big_numbers(subtrees.products[0], subtrees.products[1]);
+
+    free_big_number(subtrees.products[0]);
+    free_big_number(subtrees.products[1]);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula uma das duas metades de uma árvore de produtos.
+*
+* @param context Metades da árvore (ProductSubtrees).
+* @param index 0 para a metade da esquerda, 1 para a da direita.
+*/
+
+static void multiply_product_subtree(void *context, int index) {
+    ProductSubtrees* subtrees = context;
+
+    subtrees->products[index] = multiply_product_tree(subtrees->factors, subtrees->begin[index], subtrees->end[index]);
+}
+
+
+/*
+* @brief Calcula o "prime swing" de n, ou seja, n! / ((n/2)!)^2.
+*
+* @param n Valor do qual o swing será calculado.
+* @param primes Vetor de primos até pelo menos n.
+* @param num_primes Quantidade de primos no vetor.
+*
+* @details O expoente de cada primo p no swing é a quantidade de quocientes
+*          n / p^i ímpares. Cada potência p^e resultante é no máximo n, então
+*          todas cabem em um long long e podem ser multiplicadas pela árvore de produtos.
+*
+* @return Big Number com o valor do swing.
+*/
+
+static BigNumber prime_swing(long long n, long long *primes, int num_primes) {
+    long long* factors = malloc(sizeof(long long) * (num_primes + 1));
+    int count = 0;
+
+    for (int i = 0; i < num_primes && primes[i] <= n; i++) {
+        long long p = primes[i];
+        long long power = 1;
+        long long q = n;
+
+        while ((q /= p) > 0) {
+            if (q & 1) power *= p;
+        }
+
+        if (power > 1) factors[count++] = power;
+    }
+
+    BigNumber result = multiply_list_of_factors(factors, count);
+
+    free(factors);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula n! recursivamente pela fatoração "prime swing".
+*
+* @param n Valor não negativo.
+* @param primes Vetor de primos até pelo menos n.
+* @param num_primes Quantidade de primos no vetor.
+*
+* @details Usa a identidade n! = ((n/2)!)^2 * swing(n). Valores pequenos são
+*          calculados diretamente em um long long.
+*
+* @return Big Number com o valor de n!.
+*/
+
+BigNumber factorial_by_prime_swing(long long n, long long *primes, int num_primes) {
+    if (n < 21) {
+        long long result = 1;
+
+        for (long long i = 2; i <= n; i++) result *= i;
+
+        return create_big_number_from_long(result);
+    }
+
+    BigNumber half_factorial = factorial_by_prime_swing(n / 2, primes, num_primes);
+    BigNumber half_squared = multiply_karatsuba_big_numbers(half_factorial, half_factorial);
+    BigNumber swing = prime_swing(n, primes, num_primes);
+    BigNumber result = multiply_karatsuba_big_numbers(half_squared, swing);
+
+    free_big_number(half_factorial);
+    free_big_number(half_squared);
+    free_big_number(swing);
+
+    return result;
+}
+
+
+/*
+* @brief Acumula os dígitos de um Big Number em um vetor de colunas, sem propagar o transporte.
+*
+* @param columns Vetor de colunas, onde a posição 0 é a casa das unidades.
+* @param x Big Number a ser acumulado.
+*
+* @details Cada coluna guarda a soma dos dígitos daquela casa decimal em um long long,
+*          então o transporte pode ser adiado até o fim de todas as somas (carry-save).
+*/
+
+void accumulate_big_number(long long *columns, BigNumber x) {
+    int position = 0;
+
+    for (Node node = x->last_digit; node != NULL; node = node->prev_digit) {
+        columns[position++] += node->digit;
+    }
+}
+
+
+/*
+* @brief Acumula o produto de dois Big Numbers em um vetor de colunas, sem propagar o transporte.
+*
+* @param columns Vetor de colunas, onde a posição 0 é a casa das unidades.
+* @param x Big Number a ser multiplicado.
+* @param y Big Number a ser multiplicado.
+*
+* @details Para operandos pequenos, os produtos dígito a dígito são somados diretamente
+*          nas colunas, sem nenhuma alocação de Big Number. Para operandos maiores que
+*          bignumber_thresholds.dot_product_schoolbook, o produto é calculado pelo Karatsuba e então acumulado.
+*/
+
+void accumulate_product_of_big_numbers(long long *columns, BigNumber x, BigNumber y) {
+    int smaller_length = (x->num_digits < y->num_digits) ? x->num_digits : y->num_digits;
+
+    if (smaller_length > bignumber_thresholds.dot_product_schoolbook) {
+        BigNumber product = multiply_karatsuba_big_numbers(x, y);
+
+        accumulate_big_number(columns, product);
+        free_big_number(product);
+
+        return;
+    }
+
+    char* digits_y = malloc(y->num_digits + 1);
+    int length_y = 0;
+
+    for (Node node = y->last_digit; node != NULL; node = node->prev_digit) {
+        digits_y[length_y++] = node->digit;
+    }
+
+    int position_x = 0;
+
+    for (Node node = x->last_digit; node != NULL; node = node->prev_digit) {
+        long long* column = columns + position_x;
+        int digit_x = node->digit;
+
+        for (int j = 0; j < length_y; j++) {
+            column[j] += digit_x * digits_y[j];
+        }
+
+        position_x++;
+    }
+
+    free(digits_y);
+}
+
+
+/*
+* @brief Converte um vetor de colunas acumuladas em um Big Number.
+*
+* @param columns Vetor de colunas, onde a posição 0 é a casa das unidades.
+* @param length Quantidade de colunas do vetor.
+*
+* @details Faz uma única passagem de propagação do transporte, da casa das unidades
+*          para a mais significativa. O vetor deve ter espaço suficiente para
+*          que o último transporte seja zero.
+*
+* @return Big Number positivo com o valor representado pelas colunas.
+*/
+
+static BigNumber normalize_columns(long long *columns, int length) {
+    BigNumber result = create_big_number("");
+
+    long long carry = 0;
+
+    for (int i = 0; i < length; i++) {
+        long long value = columns[i] + carry;
+
+        add_node_to_big_number(result, value % 10, false);
+        carry = value / 10;
+    }
+
+    result->is_even = (result->last_digit->digit % 2 == 0) ? true : false;
+    remove_zeros_from_left(result);
+
+    return result;
+}
+
+
+/*
+* @brief Combina as colunas positivas e negativas de uma soma acumulada.
+*
+* @param positive_columns Colunas com os termos positivos.
+* @param negative_columns Colunas com os termos negativos.
+* @param length Quantidade de colunas dos vetores.
+*
+* @return Big Number com a diferença entre os termos positivos e negativos.
+*/
+
+BigNumber combine_signed_columns(long long *positive_columns, long long *negative_columns, int length) {
+    BigNumber positive_part = normalize_columns(positive_columns, length);
+    BigNumber negative_part = normalize_columns(negative_columns, length);
+    BigNumber result = subtract_big_numbers(positive_part, negative_part);
+
+    free_big_number(positive_part);
+    free_big_number(negative_part);
+
+    return result;
+}
+
+
+/*
+* @brief Executa um comando de múltiplos operandos ("sum k" ou "dot k").
+*
+* @param command Linha contendo o nome do comando e a quantidade de termos.
+* @param connection Conexão de onde os termos são lidos e para onde o resultado vai.
+*
+* @details Para "sum k", são lidas k linhas com os números a serem somados. Para
+*          "dot k", são lidas 2k linhas com os pares x1, y1, x2, y2, ..., e o resultado
+*          é a soma dos produtos de cada par. Como em apply_operation(), o comando é
+*          recusado se não couber nos limites da requisição (veja check_terms_budget()),
+*          e as linhas dos termos são lidas e descartadas mesmo assim.
+*/
+
+static void execute_multiple_operands_command(char *command, Connection connection) {
+    char name[16];
+    int count = 0;
+
+    if (sscanf(command, "%15s %d", name, &count) != 2 || count < 0 ||
+        (strcmp(name, "sum") != 0 && strcmp(name, "dot") != 0)) {
+        fprintf(connection->output, "Operação não conhecida\n");
+        return;
+    }
+
+    bool is_dot_product = strcmp(name, "dot") == 0;
+    int operands_per_term = is_dot_product ? 2 : 1;
+    long long num_operands = (long long) count * operands_per_term;
+    const char* budget_error = check_budget_limits(2.0 * num_operands * sizeof(BigNumber), 0);
+
+    if (budget_error != NULL || num_operands > INT_MAX) {
+        for (long long i = 0; i < num_operands && !feof(connection->input) && !connection->has_failed; i++) {
+            free(read_connection_line(connection));
+        }
+
+        if (!connection->has_failed) {
+            fprintf(connection->output, "%s\n", (budget_error != NULL) ? budget_error : "Requisição excede o limite de memória");
+        }
+
+        return;
+    }
+
+    BigNumber* numbers = malloc(sizeof(BigNumber) * (num_operands + 1));
+
+    for (int i = 0; i < num_operands; i++) {
+        char* number = read_connection_line(connection);
+
+        numbers[i] = create_big_number(number);
+        free(number);
+    }
+
+    BigNumber* x = numbers;
+    BigNumber* y = NULL;
+
+    if (is_dot_product) {
+        x = malloc(sizeof(BigNumber) * (count + 1));
+        y = malloc(sizeof(BigNumber) * (count + 1));
+
+        for (int i = 0; i < count; i++) {
+            x[i] = numbers[2 * i];
+            y[i] = numbers[2 * i + 1];
+        }
+    }
+
+    BigNumber result = NULL;
+    budget_error = check_terms_budget(x, y, count);
+
+    if (budget_error == NULL) {
+        struct RequestState request;
+        begin_request(&request, bignumber_budget.max_seconds);
+
+        result = is_dot_product ? dot_product_big_numbers(x, y, count) : sum_many_big_numbers(numbers, count);
+
+        end_request();
+
+        if (request.is_cancelled) budget_error = "Tempo limite excedido";
+    }
+
+    if (!connection->has_failed) {
+        if (budget_error != NULL) fprintf(connection->output, "%s\n", budget_error);
+        else fprint_big_number(connection->output, result);
+    }
+
+    for (int i = 0; i < num_operands; i++) {
+        free_big_number(numbers[i]);
+    }
+
+    if (result != NULL) free_big_number(result);
+
+    if (is_dot_product) {
+        free(x);
+        free(y);
+    }
+
+    free(numbers);
+}
+
+
+/*
+* @brief Verifica se uma linha é um comando de resultado parcial ("digits", "leading" ou "trailing").
+*/
+
+static bool is_partial_result_command(char *command) {
+    char name[16];
+
+    if (sscanf(command, "%15s", name) != 1) return false;
+
+    return strcmp(name, "digits") == 0 || strcmp(name, "leading") == 0 || strcmp(name, "trailing") == 0;
+}
+
+
+/*
+* @brief Executa um comando de resultado parcial.
+*
+* @param command Linha com "digits op", "leading k op" ou "trailing k op", onde op é '*' ou '^'.
+* @param connection Conexão de onde os operandos são lidos e para onde a resposta vai.
+*
+* @details Depois do comando, são lidos os dois operandos, como nas operações comuns. A
+*          resposta é a quantidade de dígitos, os k primeiros ou os k últimos dígitos do
+*          resultado de "x op y", que não é calculado inteiro (veja count_digits_of_result(),
+*          leading_digits_of_result() e trailing_digits_of_result()). Como em
+*          apply_operation(), o comando é recusado se não couber nos limites da requisição
+*          (veja check_partial_result_budget()).
+*/
+
+static void execute_partial_result_command(char *command, Connection connection) {
+    char name[16];
+    char operation = '\0';
+    int k = 0;
+
+    bool is_digits = sscanf(command, "%15s %c", name, &operation) == 2 && strcmp(name, "digits") == 0;
+    bool is_valid = is_digits || (sscanf(command, "%15s %d %c", name, &k, &operation) == 3 && k > 0);
+
+    char* number_1 = read_connection_line(connection);
+    char* number_2 = read_connection_line(connection);
+
+    BigNumber x = create_big_number(number_1);
+    BigNumber y = create_big_number(number_2);
+
+    if (connection->has_failed) {
+        is_valid = false;
+    }
+
+    else if (!is_valid || (operation != '*' && operation != '^')) {
+        fprintf(connection->output, "Operação não conhecida\n");
+        is_valid = false;
+    }
+
+    else if (x->num_digits == 0 || y->num_digits == 0) {
+        fprintf(connection->output, "Entrada inválida\n");
+        is_valid = false;
+    }
+
+    if (is_valid) {
+        const char* budget_error = check_partial_result_budget(operation, x, y, k, strcmp(name, "trailing") == 0);
+
+        if (budget_error != NULL) {
+            fprintf(connection->output, "%s\n", budget_error);
+            is_valid = false;
+        }
+    }
+
+    if (is_valid) {
+        struct RequestState request;
+        BigNumber result = NULL;
+        long long num_digits = -1;
+
+        begin_request(&request, bignumber_budget.max_seconds);
+
+        if (is_digits) num_digits = count_digits_of_result(operation, x, y);
+        else if (strcmp(name, "leading") == 0) result = leading_digits_of_result(operation, x, y, k);
+        else result = trailing_digits_of_result(operation, x, y, k);
+
+        end_request();
+
+        if (request.is_cancelled) fprintf(connection->output, "Tempo limite excedido\n");
+        else if (result != NULL) fprint_big_number(connection->output, result);
+        else if (num_digits >= 0) fprintf(connection->output, "%lld\n", num_digits);
+        else fprintf(connection->output, "Entrada inválida\n");
+
+        if (result != NULL) free_big_number(result);
+    }
+
+    free_big_number(x);
+    free_big_number(y);
+    free(number_1);
+    free(number_2);
+}
+
+
+/*
+* @brief Cria uma cópia independente de um Big Number.
+*
+* @param x Big Number a ser copiado.
+*
+* @return Big Number com os mesmos dígitos e sinal de x.
+*/
+
+BigNumber duplicate_big_number(BigNumber x) {
+    BigNumber copy = create_big_number("");
+
+    copy_big_number(copy, x, x->num_digits, false);
+
+    copy->is_positive = x->is_positive;
+    copy->is_even = x->is_even;
+
+    return copy;
+}
+
+
+/*
+* @brief Cria uma tabela de registradores vazia.
+*
+* @return A tabela criada.
+*/
+
+static RegisterTable create_register_table() {
+    RegisterTable table = (RegisterTable)malloc(sizeof(struct RegisterTable));
+
+    table->count = 0;
+    table->capacity = 8;
+    table->registers = malloc(sizeof(struct Register) * table->capacity);
+
+    return table;
+}
+
+
+/*
+* @brief Libera a tabela de registradores e todos os Big Numbers guardados nela.
+*
+* @param table Tabela a ser liberada.
+*/
+
+static void free_register_table(RegisterTable table) {
+    for (int i = 0; i < table->count; i++) {
+        free(table->registers[i].name);
+        free_big_number(table->registers[i].value);
+    }
+
+    free(table->registers);
+    free(table);
+}
+
+
+/*
+* @brief Procura um registrador pelo nome.
+*
+* @param table Tabela de registradores.
+* @param name Nome do registrador.
+*
+* @return Big Number guardado no registrador, ou NULL se ele não existir.
+*/
+
+static BigNumber find_register(RegisterTable table, const char *name) {
+    for (int i = 0; i < table->count; i++) {
+        if (strcmp(table->registers[i].name, name) == 0) return table->registers[i].value;
+    }
+
+    return NULL;
+}
+
+
+/*
+* @brief Guarda um Big Number em um registrador.
+*
+* @param table Tabela de registradores.
+* @param name Nome do registrador.
+* @param value Big Number a ser guardado. A tabela passa a ser responsável por liberá-lo.
+*
+* @details Se o registrador já existir, o valor antigo é liberado e substituído.
+*/
+
+static void set_register(RegisterTable table, const char *name, BigNumber value) {
+    for (int i = 0; i < table->count; i++) {
+        if (strcmp(table->registers[i].name, name) == 0) {
+            free_big_number(table->registers[i].value);
+            table->registers[i].value = value;
+            return;
+        }
+    }
+
+    if (table->count == table->capacity) {
+        table->capacity *= 2;
+        table->registers = realloc(table->registers, sizeof(struct Register) * table->capacity);
+    }
+
+    table->registers[table->count].name = malloc(strlen(name) + 1);
+    strcpy(table->registers[table->count].name, name);
+    table->registers[table->count].value = value;
+    table->count++;
+}
+
+
+/*
+* @brief Verifica se uma linha da entrada pertence ao modo de registradores.
+*
+* @param line Linha lida da entrada.
+*
+* @details Uma linha do modo de registradores começa com uma letra e contém uma
+*          atribuição ("r1 = a * b") ou um comando "print".
+*
+* @return true, se a linha deve ser executada como uma sequência de instruções.
+*/
+
+static bool is_statement_line(char *line) {
+    if (!isalpha((unsigned char) line[0])) return false;
+    if (strchr(line, '=') != NULL) return true;
+
+    return strncmp(line, "print", 5) == 0 && (line[5] == '\0' || isspace((unsigned char) line[5]));
+}
+
+
+/*
+* @brief Lê um identificador (letras, dígitos e '_') a partir da posição atual.
+*
+* @param cursor Ponteiro para a posição atual da string, que é avançada.
+* @param name Buffer onde o identificador será copiado.
+* @param size Tamanho do buffer.
+*
+* @return Quantidade de caracteres lidos (0 se não houver identificador).
+*/
+
+static int read_identifier(char **cursor, char *name, int size) {
+    int length = 0;
+
+    if (!isalpha((unsigned char) **cursor) && **cursor != '_') return 0;
+
+    while (isalnum((unsigned char) **cursor) || **cursor == '_') {
+        if (length + 1 < size) name[length++] = **cursor;
+        (*cursor)++;
+    }
+
+    name[length] = '\0';
+
+    return length;
+}
+
+
+/*
+* @brief Pula os espaços a partir da posição atual.
+*
+* @param cursor Ponteiro para a posição atual da string, que é avançada.
+*/
+
+static void skip_spaces(char **cursor) {
+    while (isspace((unsigned char) **cursor)) (*cursor)++;
+}
+
+
+/*
+* @brief Lê um operando de uma expressão: um número literal ou o nome de um registrador.
+*
+* @param cursor Ponteiro para a posição atual da expressão, que é avançada.
+* @param table Tabela de registradores.
+* @param is_owned Indica se o Big Number retornado foi criado aqui e deve ser liberado.
+* @param error Ponteiro onde a mensagem de erro será armazenada, se houver.
+*
+* @return Big Number do operando, ou NULL em caso de erro.
+*/
+
+static BigNumber parse_operand(char **cursor, RegisterTable table, bool *is_owned, const char **error) {
+    char name[64];
+
+    skip_spaces(cursor);
+    *is_owned = false;
+
+    if (read_identifier(cursor, name, sizeof(name)) > 0) {
+        BigNumber value = find_register(table, name);
+
+        if (value == NULL) *error = "Registrador não definido";
+
+        return value;
+    }
+
+    char* begin = *cursor;
+
+    if (**cursor == '-') (*cursor)++;
+
+    if (!isdigit((unsigned char) **cursor)) {
+        *error = "Expressão inválida";
+        return NULL;
+    }
+
+    while (isdigit((unsigned char) **cursor)) (*cursor)++;
+
+    char saved = **cursor;
+    **cursor = '\0';
+
+    BigNumber value = create_big_number(begin);
+    remove_zeros_from_left(value);
+
+    **cursor = saved;
+    *is_owned = true;
+
+    return value;
+}
+
+
+/*
+* @brief Avalia uma expressão do modo de registradores.
+*
+* @param expression Expressão no formato "operando" ou "operando operação operando".
+* @param table Tabela de registradores.
+* @param error Ponteiro onde a mensagem de erro será armazenada, se houver.
+*
+* @details As operações são as mesmas aceitas por apply_operation(). As operações
+*          com nome ('x', 'C', 'P' e "divexact") devem ser separadas dos operandos por espaços,
+*          e o fatorial pode ser escrito sem o segundo operando ("n !").
+*
+* @return Novo Big Number com o resultado, ou NULL em caso de erro.
+*/
+
+static BigNumber evaluate_expression(char *expression, RegisterTable table, const char **error) {
+    char* cursor = expression;
+    bool is_owned_x, is_owned_y = false;
+
+    BigNumber x = parse_operand(&cursor, table, &is_owned_x, error);
+
+    if (x == NULL) return NULL;
+
+    skip_spaces(&cursor);
+
+    if (*cursor == '\0') return is_owned_x ? x : duplicate_big_number(x);
+
+    char operation;
+    char name[64];
+
+    if (read_identifier(&cursor, name, sizeof(name)) > 0) {
+        operation = (strlen(name) == 1 || find_operation(name) != name[0]) ? find_operation(name) : '?';
+    }
+
+    else {
+        operation = *cursor++;
+    }
+
+    BigNumber y;
+    skip_spaces(&cursor);
+
+    if (operation == '!' && *cursor == '\0') {
+        y = x;
+    }
+
+    else {
+        y = parse_operand(&cursor, table, &is_owned_y, error);
+        skip_spaces(&cursor);
+
+        if (y != NULL && *cursor != '\0') {
+            *error = "Expressão inválida";
+            if (is_owned_y) free_big_number(y);
+            y = NULL;
+        }
+    }
+
+    BigNumber result = (y != NULL) ? apply_operation(operation, x, y, error) : NULL;
+
+    if (is_owned_x) free_big_number(x);
+    if (is_owned_y) free_big_number(y);
+
+    return result;
+}
+
+
+/*
+* @brief Executa uma linha do modo de registradores.
+*
+* @param line Linha com instruções separadas por ';'.
+* @param table Tabela de registradores, mantida entre as linhas.
+* @param output Arquivo onde os resultados e erros são escritos.
+*
+* @details Cada instrução é uma atribuição ("r1 = a * b"), que guarda o resultado no
+*          registrador sem convertê-lo para texto, ou um "print expressão", que imprime
+*          o resultado em decimal. Erros são impressos em uma linha própria e não
+*          interrompem as instruções seguintes.
+*/
+
+static void execute_statements(char *line, RegisterTable table, FILE *output) {
+    char* statement = line;
+
+    while (statement != NULL) {
+        char* separator = strchr(statement, ';');
+        if (separator != NULL) *separator = '\0';
+
+        char* cursor = statement;
+        char name[64];
+        const char* error = NULL;
+
+        skip_spaces(&cursor);
+
+        if (*cursor != '\0') {
+            char* after_name = cursor;
+            int length = read_identifier(&after_name, name, sizeof(name));
+            BigNumber result = NULL;
+
+            if (length > 0 && strcmp(name, "print") == 0 && strchr(cursor, '=') == NULL) {
+                result = evaluate_expression(after_name, table, &error);
+
+                if (result != NULL) {
+                    fprint_big_number(output, result);
+                    free_big_number(result);
+                }
+            }
+
+            else {
+                skip_spaces(&after_name);
+
+                if (length > 0 && *after_name == '=') {
+                    result = evaluate_expression(after_name + 1, table, &error);
+
+                    if (result != NULL) set_register(table, name, result);
+                }
+
+                else {
+                    error = "Expressão inválida";
+                }
+            }
+
+            if (result == NULL) fprintf(output, "%s\n", error);
+        }
+
+        statement = (separator != NULL) ? separator + 1 : NULL;
+    }
+}
@@ -1,16 +1,50 @@
 #ifndef auxiliar_h
 #define auxiliar_h
 
+#include <stdio.h>
+#include <stddef.h>
 #include "bignumber.h"
 
+#define PRODUCT_TREE_PARALLEL_LEAVES 64
+#define PRODUCT_OF_RANGE_MAX_FACTORS (1 << 26)
+
+typedef struct ProductSubtrees {
+    long long *factors;
+    int begin[2];
+    int end[2];
+    BigNumber products[2];
+} ProductSubtrees;
+
+typedef struct Connection {
+    FILE *input;
+    FILE *output;
+    size_t max_line_length;
+    bool flush_each_response;
+    bool has_failed;
+}* Connection;
+
+typedef struct Register {
+    char *name;
+    BigNumber value;
+} Register;
+
+typedef struct RegisterTable {
+    int count;
+    int capacity;
+    Register *registers;
+}* RegisterTable;
+
 char* read_input();
+Connection create_connection(FILE *input, FILE *output, size_t max_line_length, bool flush_each_response);
 void execute_program();
+void execute_connection(Connection connection);
+char find_operation(const char *operation);
+BigNumber apply_operation(char operation, BigNumber x, BigNumber y, const char **error);
 
 Node create_node(int digit);
 void add_node_to_big_number(BigNumber big_number, int digit, bool insert_at_end);
 
 int compare_big_numbers_modules(BigNumber x, BigNumber y);
-void copy_big_number(BigNumber big_number_dest, BigNumber big_number_orig, int tam, bool in_left);
 void remove_zeros_from_left(BigNumber big_number);
 
 BigNumber switch_to_sum_or_subtraction(char *switch_to, bool sign, BigNumber x, BigNumber y, BigNumber result);
@@ -20,4 +54,16 @@ void determine_order_of_subtraction(BigNumber x, Node* node_x, BigNumber y, Node
 BigNumber divide_by_power_of_ten(BigNumber x, int power);
 BigNumber get_remainder_by_power_of_ten(BigNumber x, int power);
 
+bool big_number_to_long(BigNumber x, long long *value);
+
+long long* list_primes_up_to(long long limit, int *count);
+BigNumber multiply_list_of_factors(long long *factors, int count);
+BigNumber factorial_by_prime_swing(long long n, long long *primes, int num_primes);
+
+void accumulate_big_number(long long *columns, BigNumber x);
+void accumulate_product_of_big_numbers(long long *columns, BigNumber x, BigNumber y);
+BigNumber combine_signed_columns(long long *positive_columns, long long *negative_columns, int length);
+
+BigNumber duplicate_big_number(BigNumber x);
+
 #endif
\ No newline at end of file
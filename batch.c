@@ -0,0 +1,675 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "auxiliar.h"
+#include "batch.h"
+#include "budget.h"
+#include "bignumber.h"
+#include "limbs.h"
+#include "wire.h"
+
+
+/*
+* @brief Cria um lote vazio de números pequenos.
+*
+* @param capacity Quantidade máxima de números no lote.
+*
+* @details O lote guarda os números em formato de estrutura de vetores: limbs[k][i] é o
+*          limb k (de base 10^9) do número i. Assim, cada operação percorre os números
+*          com acessos contíguos e sem dependência entre eles, e o compilador pode usar
+*          instruções SIMD que operam vários números ao mesmo tempo.
+*
+* @return O lote criado.
+*/
+
+BigNumberBatch create_batch(int capacity) {
+    BigNumberBatch batch = (BigNumberBatch)malloc(sizeof(struct BigNumberBatch));
+
+    batch->count = 0;
+    batch->capacity = capacity;
+    batch->is_positive = malloc(capacity);
+
+    for (int k = 0; k < BATCH_OUTPUT_LIMBS; k++) {
+        batch->limbs[k] = malloc(sizeof(Limb) * capacity);
+    }
+
+    return batch;
+}
+
+
+/*
+* @brief Esvazia um lote, mantendo a memória alocada para reaproveitá-lo.
+*/
+
+void clear_batch(BigNumberBatch batch) {
+    batch->count = 0;
+}
+
+
+/*
+* @brief Libera a memória de um lote.
+*/
+
+void free_batch(BigNumberBatch batch) {
+    for (int k = 0; k < BATCH_OUTPUT_LIMBS; k++) free(batch->limbs[k]);
+
+    free(batch->is_positive);
+    free(batch);
+}
+
+
+/*
+* @brief Adiciona um número, dado em decimal, ao final do lote.
+*
+* @param batch Lote de destino.
+* @param str_number String do número.
+*
+* @return false, nos mesmos casos de batch_append_digits().
+*/
+
+bool batch_append(BigNumberBatch batch, const char *str_number) {
+    return batch_append_digits(batch, str_number, strlen(str_number));
+}
+
+
+/*
+* @brief Adiciona um número, dado pelos seus length primeiros caracteres, ao final do lote.
+*
+* @param batch Lote de destino.
+* @param str_number Caracteres do número (não precisam terminar em '\0').
+* @param length Quantidade de caracteres.
+*
+* @details O número é convertido diretamente para os limbs do lote, um limb de cada vez
+*          a partir do fim da string, sem criar um Big Number nem uma cópia da string.
+*
+* @return false, se o lote estiver cheio, se o número tiver mais de BATCH_MAX_DIGITS dígitos
+*         ou se tiver algum caractere inválido.
+*/
+
+bool batch_append_digits(BigNumberBatch batch, const char *str_number, int length) {
+    if (batch->count == batch->capacity) return false;
+
+    bool is_positive = true;
+
+    if (length > 0 && *str_number == '-') {
+        is_positive = false;
+        str_number++;
+        length--;
+    }
+
+    if (length == 0 || length > BATCH_MAX_DIGITS) return false;
+
+    Limb limbs[BATCH_OUTPUT_LIMBS] = {0};
+
+    for (int k = 0, end = length; end > 0; k++, end -= LIMB_DIGITS) {
+        int begin = (end > LIMB_DIGITS) ? end - LIMB_DIGITS : 0;
+        Limb limb = 0;
+
+        for (int i = begin; i < end; i++) {
+            unsigned int digit = (unsigned char) str_number[i] - '0';
+
+            if (digit > 9) return false;
+
+            limb = limb * 10 + digit;
+        }
+
+        limbs[k] = limb;
+    }
+
+    int lane = batch->count++;
+
+    for (int k = 0; k < BATCH_OUTPUT_LIMBS; k++) batch->limbs[k][lane] = limbs[k];
+
+    batch->is_positive[lane] = is_positive;
+
+    return true;
+}
+
+
+/*
+* @brief Soma com sinal, número a número, de dois lotes do mesmo tamanho.
+*
+* @param x Lote com os primeiros operandos.
+* @param y Lote com os segundos operandos.
+* @param negate_y Se verdadeiro, calcula x - y.
+* @param result Lote onde os resultados são escritos.
+*
+* @details Para cada número são calculados, limb a limb, |x| + |y|, |x| - |y| e |y| - |x|,
+*          sem desvios; no final, o resultado certo é escolhido pelos sinais e pelo último
+*          empréstimo. Todos os laços internos percorrem os números do lote.
+*/
+
+void batch_add_signed(BigNumberBatch x, BigNumberBatch y, bool negate_y, BigNumberBatch result) {
+    int count = x->count;
+
+    uint32_t* carry_sum = calloc(count, sizeof(uint32_t));
+    uint32_t* borrow_xy = calloc(count, sizeof(uint32_t));
+    uint32_t* borrow_yx = calloc(count, sizeof(uint32_t));
+    Limb* difference_xy[BATCH_INPUT_LIMBS + 1];
+    Limb* difference_yx[BATCH_INPUT_LIMBS + 1];
+
+    for (int k = 0; k <= BATCH_INPUT_LIMBS; k++) {
+        Limb* limbs_x = x->limbs[k];
+        Limb* limbs_y = y->limbs[k];
+        Limb* limbs_sum = result->limbs[k];
+
+        difference_xy[k] = malloc(sizeof(Limb) * count);
+        difference_yx[k] = malloc(sizeof(Limb) * count);
+
+        for (int i = 0; i < count; i++) {
+            uint32_t sum = limbs_x[i] + limbs_y[i] + carry_sum[i];
+            uint32_t overflow = sum >= LIMB_BASE;
+
+            limbs_sum[i] = sum - overflow * LIMB_BASE;
+            carry_sum[i] = overflow;
+
+            int64_t sub_xy = (int64_t) limbs_x[i] - limbs_y[i] - borrow_xy[i];
+            int64_t sub_yx = (int64_t) limbs_y[i] - limbs_x[i] - borrow_yx[i];
+
+            borrow_xy[i] = sub_xy < 0;
+            borrow_yx[i] = sub_yx < 0;
+            difference_xy[k][i] = sub_xy + borrow_xy[i] * (int64_t) LIMB_BASE;
+            difference_yx[k][i] = sub_yx + borrow_yx[i] * (int64_t) LIMB_BASE;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        bool sign_y = negate_y ? !y->is_positive[i] : y->is_positive[i];
+        bool same_sign = x->is_positive[i] == sign_y;
+
+        if (same_sign) {
+            result->is_positive[i] = x->is_positive[i];
+        }
+
+        else if (borrow_xy[i] == 0) {
+            result->is_positive[i] = x->is_positive[i];
+            for (int k = 0; k <= BATCH_INPUT_LIMBS; k++) result->limbs[k][i] = difference_xy[k][i];
+        }
+
+        else {
+            result->is_positive[i] = sign_y;
+            for (int k = 0; k <= BATCH_INPUT_LIMBS; k++) result->limbs[k][i] = difference_yx[k][i];
+        }
+    }
+
+    for (int k = BATCH_INPUT_LIMBS + 1; k < BATCH_OUTPUT_LIMBS; k++) {
+        memset(result->limbs[k], 0, sizeof(Limb) * count);
+    }
+
+    for (int k = 0; k <= BATCH_INPUT_LIMBS; k++) {
+        free(difference_xy[k]);
+        free(difference_yx[k]);
+    }
+
+    free(carry_sum);
+    free(borrow_xy);
+    free(borrow_yx);
+
+    result->count = count;
+}
+
+
+/*
+* @brief Soma, número a número, dois lotes do mesmo tamanho.
+*/
+
+void batch_sum(BigNumberBatch x, BigNumberBatch y, BigNumberBatch result) {
+    batch_add_signed(x, y, false, result);
+}
+
+
+/*
+* @brief Subtrai, número a número, dois lotes do mesmo tamanho.
+*/
+
+void batch_subtract(BigNumberBatch x, BigNumberBatch y, BigNumberBatch result) {
+    batch_add_signed(x, y, true, result);
+}
+
+
+/*
+* @brief Multiplica, número a número, dois lotes do mesmo tamanho.
+*
+* @param x Lote com os primeiros operandos.
+* @param y Lote com os segundos operandos.
+* @param result Lote onde os resultados são escritos (não pode ser x nem y).
+*
+* @details Método tradicional por colunas: cada coluna do produto soma até
+*          BATCH_INPUT_LIMBS produtos de limbs em 64 bits, e o transporte de cada número
+*          é guardado em um vetor próprio, então o laço interno não tem dependência entre números.
+*/
+
+void batch_multiply(BigNumberBatch x, BigNumberBatch y, BigNumberBatch result) {
+    int count = x->count;
+    uint64_t* accumulator = calloc(count, sizeof(uint64_t));
+
+    for (int column = 0; column < BATCH_OUTPUT_LIMBS; column++) {
+        int first = (column >= BATCH_INPUT_LIMBS) ? column - BATCH_INPUT_LIMBS + 1 : 0;
+        int last = (column < BATCH_INPUT_LIMBS) ? column : BATCH_INPUT_LIMBS - 1;
+
+        for (int j = first; j <= last; j++) {
+            const Limb* limbs_x = x->limbs[j];
+            const Limb* limbs_y = y->limbs[column - j];
+
+            for (int i = 0; i < count; i++) {
+                accumulator[i] += (uint64_t) limbs_x[i] * limbs_y[i];
+            }
+        }
+
+        Limb* limbs_result = result->limbs[column];
+
+        for (int i = 0; i < count; i++) {
+            limbs_result[i] = accumulator[i] % LIMB_BASE;
+            accumulator[i] /= LIMB_BASE;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        result->is_positive[i] = x->is_positive[i] == y->is_positive[i];
+    }
+
+    free(accumulator);
+
+    result->count = count;
+}
+
+
+/*
+* @brief Divide todos os números de um lote por um mesmo divisor pequeno.
+*
+* @param x Lote com os dividendos.
+* @param divisor Módulo do divisor (menor que 10^9).
+* @param divisor_is_positive Sinal do divisor.
+* @param result Lote onde os quocientes são escritos.
+*
+* @details Divisão curta, do limb mais significativo para o menos, com o resto de cada
+*          número em um vetor próprio. O quociente é truncado em direção ao zero, como em
+*          divide_big_numbers(), e a divisão por zero resulta em zero.
+*/
+
+void batch_divide_by_limb(BigNumberBatch x, Limb divisor, bool divisor_is_positive, BigNumberBatch result) {
+    int count = x->count;
+    uint64_t* remainder = calloc(count, sizeof(uint64_t));
+
+    for (int k = BATCH_OUTPUT_LIMBS - 1; k >= 0; k--) {
+        Limb* limbs_x = x->limbs[k];
+        Limb* limbs_result = result->limbs[k];
+
+        if (divisor == 0) {
+            memset(limbs_result, 0, sizeof(Limb) * count);
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            uint64_t current = remainder[i] * LIMB_BASE + limbs_x[i];
+
+            limbs_result[i] = current / divisor;
+            remainder[i] = current % divisor;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        result->is_positive[i] = x->is_positive[i] == divisor_is_positive;
+    }
+
+    free(remainder);
+
+    result->count = count;
+}
+
+
+/* Pares de dígitos de 00 a 99, para escrever dois dígitos por divisão. */
+
+static const char digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+/*
+* @brief Escreve um número do lote em decimal, seguido de uma quebra de linha.
+*
+* @param batch Lote.
+* @param lane Índice do número no lote.
+* @param output Buffer com pelo menos BATCH_LANE_TEXT_SIZE bytes.
+*
+* @details Os dígitos são escritos diretamente, limb a limb, sem passar por sprintf().
+*
+* @return Quantidade de bytes escritos.
+*/
+
+int format_batch_lane(BigNumberBatch batch, int lane, char *output) {
+    int top = BATCH_OUTPUT_LIMBS - 1;
+    int length = 0;
+
+    while (top > 0 && batch->limbs[top][lane] == 0) top--;
+
+    if (!batch->is_positive[lane] && (top > 0 || batch->limbs[0][lane] != 0)) output[length++] = '-';
+
+    char top_digits[LIMB_DIGITS];
+    int num_top_digits = 0;
+    Limb top_limb = batch->limbs[top][lane];
+
+    do {
+        top_digits[num_top_digits++] = '0' + top_limb % 10;
+        top_limb /= 10;
+    } while (top_limb != 0);
+
+    while (num_top_digits > 0) output[length++] = top_digits[--num_top_digits];
+
+    for (int k = top - 1; k >= 0; k--) {
+        Limb limb = batch->limbs[k][lane];
+
+        for (int j = LIMB_DIGITS - 2; j > 0; j -= 2) {
+            memcpy(output + length + j, &digit_pairs[2 * (limb % 100)], 2);
+            limb /= 100;
+        }
+
+        output[length] = '0' + limb;
+
+        length += LIMB_DIGITS;
+    }
+
+    output[length++] = '\n';
+
+    return length;
+}
+
+
+/*
+* @brief Verifica se todos os divisores do lote são iguais e cabem em um único limb.
+*
+* @param y Lote com os divisores.
+*
+* @return true, se a divisão pode ser feita por batch_divide_by_limb().
+*/
+
+bool has_common_small_divisor(BigNumberBatch y) {
+    for (int i = 0; i < y->count; i++) {
+        for (int k = 1; k < BATCH_INPUT_LIMBS; k++) {
+            if (y->limbs[k][i] != 0) return false;
+        }
+
+        if (y->limbs[0][i] != y->limbs[0][0] || y->is_positive[i] != y->is_positive[0]) return false;
+    }
+
+    return true;
+}
+
+
+/*
+* @brief Copia um número do lote para uma string decimal alocada dinamicamente.
+*/
+
+char* copy_batch_lane(BigNumberBatch batch, int lane) {
+    char* text = malloc(BATCH_LANE_TEXT_SIZE);
+    int length = format_batch_lane(batch, lane, text);
+
+    text[length - 1] = '\0';
+
+    return text;
+}
+
+
+/*
+* @brief Copia os length primeiros caracteres de uma linha para uma string alocada dinamicamente.
+*/
+
+char* copy_batch_line(const char *line, size_t length) {
+    char* text = malloc(length + 1);
+
+    memcpy(text, line, length);
+    text[length] = '\0';
+
+    return text;
+}
+
+
+/*
+* @brief Lê a próxima linha da entrada do modo em lote.
+*
+* @param reader Leitor, com o buffer que guarda os bytes lidos e ainda não consumidos.
+* @param length Ponteiro onde o tamanho da linha (sem a quebra de linha) é escrito.
+*
+* @details A entrada é lida em blocos grandes com fread(), e a linha é devolvida dentro
+*          do próprio buffer, terminada em '\0', sem cópia. O buffer cresce quando uma
+*          linha não cabe nele, até reader->max_line_length bytes (0 para não ter limite);
+*          uma linha maior é descartada até a quebra de linha, reader->is_too_long é
+*          marcado e uma linha vazia é devolvida.
+*
+* @return A linha (válida até a próxima chamada), ou NULL no fim da entrada.
+*/
+
+char* read_batch_line(BatchReader *reader, size_t *length) {
+    reader->is_too_long = false;
+
+    while (true) {
+        char* line = reader->data + reader->start;
+        char* newline = memchr(line, '\n', reader->end - reader->start);
+
+        if (newline != NULL || (reader->is_finished && reader->start < reader->end)) {
+            *length = (newline != NULL) ? (size_t)(newline - line) : reader->end - reader->start;
+            line[*length] = '\0';
+            reader->start += (newline != NULL) ? *length + 1 : *length;
+
+            if (reader->is_too_long) {
+                *length = 0;
+                *line = '\0';
+            }
+
+            return line;
+        }
+
+        if (reader->is_finished) {
+            if (!reader->is_too_long) return NULL;
+
+            *length = 0;
+            reader->data[0] = '\0';
+
+            return reader->data;
+        }
+
+        if (reader->max_line_length > 0 && reader->end - reader->start > reader->max_line_length) {
+            reader->is_too_long = true;
+            reader->start = reader->end;
+        }
+
+        memmove(reader->data, line, reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->start = 0;
+
+        if (reader->capacity - reader->end < BATCH_READ_SIZE) {
+            reader->capacity *= 2;
+            reader->data = realloc(reader->data, reader->capacity);
+        }
+
+        size_t size = fread(reader->data + reader->end, 1, reader->capacity - reader->end - 1, reader->input);
+
+        reader->end += size;
+
+        if (size == 0) reader->is_finished = true;
+    }
+}
+
+
+/*
+* @brief Calcula e escreve um bloco de requisições do modo em lote.
+*
+* @param operation Operação de todas as requisições.
+* @param numbers Strings dos operandos que não estão nos lotes, em pares (x0, y0, x1, y1, ...).
+* @param lanes Para cada par, o índice dele nos lotes, -1 se ele não estiver nos lotes ou
+*              BATCH_LANE_TOO_LONG se algum operando passou do limite de memória.
+* @param count Quantidade de pares.
+* @param x Lote com os primeiros operandos.
+* @param y Lote com os segundos operandos.
+* @param result Lote de trabalho para os resultados.
+*
+* @details Os pares que estão nos lotes são calculados pelos algoritmos em lote; os demais
+*          (ou todos, se a divisão não tiver um divisor comum pequeno) usam apply_operation().
+*          Os resultados são montados em um único buffer, na ordem da entrada, e escritos de uma vez.
+*/
+
+void execute_batch_chunk(char operation, char **numbers, int *lanes, int count, BigNumberBatch x, BigNumberBatch y,
+                         BigNumberBatch result) {
+    if (operation == '/' && x->count > 0 && !has_common_small_divisor(y)) {
+        for (int i = 0; i < count; i++) {
+            if (lanes[i] < 0) continue;
+
+            numbers[2 * i] = copy_batch_lane(x, lanes[i]);
+            numbers[2 * i + 1] = copy_batch_lane(y, lanes[i]);
+            lanes[i] = -1;
+        }
+
+        clear_batch(x);
+    }
+
+    if (x->count > 0) {
+        if (operation == '+') batch_sum(x, y, result);
+        else if (operation == '-') batch_subtract(x, y, result);
+        else if (operation == '*') batch_multiply(x, y, result);
+        else batch_divide_by_limb(x, y->limbs[0][0], y->is_positive[0], result);
+    }
+
+    ByteBuffer output = {NULL, 0, 0};
+    char lane_text[BATCH_LANE_TEXT_SIZE];
+
+    for (int i = 0; i < count; i++) {
+        if (lanes[i] >= 0) {
+            append_bytes(&output, lane_text, format_batch_lane(result, lanes[i], lane_text));
+            continue;
+        }
+
+        if (lanes[i] == BATCH_LANE_TOO_LONG) {
+            const char* error = "Requisição excede o limite de memória\n";
+
+            append_bytes(&output, error, strlen(error));
+            continue;
+        }
+
+        BigNumber big_num1 = create_big_number(numbers[2 * i]);
+        BigNumber big_num2 = create_big_number(numbers[2 * i + 1]);
+
+        const char* error = NULL;
+        BigNumber big_result = apply_operation(operation, big_num1, big_num2, &error);
+
+        if (big_result != NULL) {
+            for (Node node = big_result->first_digit; node != NULL; node = node->next_digit) {
+                char digit = '0' + node->digit;
+
+                if (node == big_result->first_digit && !big_result->is_positive) append_bytes(&output, "-", 1);
+                append_bytes(&output, &digit, 1);
+            }
+
+            free_big_number(big_result);
+        }
+
+        else {
+            append_bytes(&output, error, strlen(error));
+        }
+
+        append_bytes(&output, "\n", 1);
+
+        free_big_number(big_num1);
+        free_big_number(big_num2);
+    }
+
+    fwrite(output.data, 1, output.size, stdout);
+
+    free(output.data);
+}
+
+
+/*
+* @brief Executa o programa no modo em lote.
+*
+* @details A primeira linha da entrada tem a operação, que vale para todas as requisições,
+*          e as linhas seguintes têm os pares de números, um por linha, até o fim da entrada
+*          (ou uma linha vazia). Os pares são processados em blocos de BATCH_CHUNK, e cada
+*          resultado é impresso em uma linha, como em execute_program(). Os números pequenos
+*          são convertidos do buffer de leitura direto para os lotes; só os demais são copiados.
+*          Um operando com mais dígitos do que o limite de memória permite (veja
+*          get_max_digits_in_budget()) nem chega a ser guardado, e o par é recusado.
+*/
+
+void execute_batch_program() {
+    size_t max_digits = get_max_digits_in_budget();
+    BatchReader reader = {stdin, malloc(2 * BATCH_READ_SIZE), 0, 0, 2 * BATCH_READ_SIZE,
+                          (max_digits > 0) ? max_digits + 1 : 0, false, false};
+    size_t length;
+
+    char* line = read_batch_line(&reader, &length);
+    char operation = find_operation((line != NULL) ? line : "");
+    bool has_batch_kernel = operation == '+' || operation == '-' || operation == '*' || operation == '/';
+
+    BigNumberBatch x = create_batch(BATCH_CHUNK);
+    BigNumberBatch y = create_batch(BATCH_CHUNK);
+    BigNumberBatch result = create_batch(BATCH_CHUNK);
+    char** numbers = calloc(2 * BATCH_CHUNK, sizeof(char*));
+    int* lanes = malloc(sizeof(int) * BATCH_CHUNK);
+    bool has_finished = (line == NULL);
+
+    while (!has_finished) {
+        int count = 0;
+
+        clear_batch(x);
+        clear_batch(y);
+
+        while (count < BATCH_CHUNK) {
+            line = read_batch_line(&reader, &length);
+
+            if (line == NULL || (length == 0 && !reader.is_too_long)) {
+                has_finished = true;
+                break;
+            }
+
+            bool is_too_long = reader.is_too_long;
+            bool is_in_lanes = !is_too_long && has_batch_kernel && batch_append_digits(x, line, length);
+            char x_text[BATCH_MAX_DIGITS + 2];
+            size_t x_length = length;
+
+            if (is_in_lanes) memcpy(x_text, line, x_length);
+            else if (!is_too_long) numbers[2 * count] = copy_batch_line(line, length);
+
+            line = read_batch_line(&reader, &length);
+            is_too_long = is_too_long || reader.is_too_long;
+            lanes[count] = -1;
+
+            if (is_in_lanes && !is_too_long && line != NULL && batch_append_digits(y, line, length)) {
+                lanes[count] = x->count - 1;
+            }
+
+            else if (is_too_long) {
+                if (is_in_lanes) x->count--;
+                lanes[count] = BATCH_LANE_TOO_LONG;
+            }
+
+            else {
+                if (is_in_lanes) {
+                    x->count--;
+                    numbers[2 * count] = copy_batch_line(x_text, x_length);
+                }
+
+                numbers[2 * count + 1] = copy_batch_line((line != NULL) ? line : "", (line != NULL) ? length : 0);
+            }
+
+            count++;
+        }
+
+        execute_batch_chunk(operation, numbers, lanes, count, x, y, result);
+
+        for (int i = 0; i < 2 * count; i++) {
+            free(numbers[i]);
+            numbers[i] = NULL;
+        }
+    }
+
+    free(lanes);
+    free(numbers);
+    free_batch(x);
+    free_batch(y);
+    free_batch(result);
+    free(reader.data);
+}
@@ -0,0 +1,52 @@
+#ifndef batch_h
+#define batch_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "limbs.h"
+
+#define BATCH_MAX_DIGITS 40
+#define BATCH_INPUT_LIMBS 5
+#define BATCH_OUTPUT_LIMBS 10
+#define BATCH_CHUNK 4096
+#define BATCH_LANE_TEXT_SIZE (BATCH_OUTPUT_LIMBS * LIMB_DIGITS + 2)
+#define BATCH_READ_SIZE (1 << 20)
+#define BATCH_LANE_TOO_LONG -2
+
+typedef struct BigNumberBatch {
+    int count;
+    int capacity;
+    uint8_t *is_positive;
+    Limb *limbs[BATCH_OUTPUT_LIMBS];
+}* BigNumberBatch;
+
+typedef struct BatchReader {
+    FILE *input;
+    char *data;
+    size_t start;
+    size_t end;
+    size_t capacity;
+    size_t max_line_length;
+    bool is_finished;
+    bool is_too_long;
+} BatchReader;
+
+BigNumberBatch create_batch(int capacity);
+void clear_batch(BigNumberBatch batch);
+void free_batch(BigNumberBatch batch);
+bool batch_append(BigNumberBatch batch, const char *str_number);
+bool batch_append_digits(BigNumberBatch batch, const char *str_number, int length);
+
+void batch_sum(BigNumberBatch x, BigNumberBatch y, BigNumberBatch result);
+void batch_subtract(BigNumberBatch x, BigNumberBatch y, BigNumberBatch result);
+void batch_multiply(BigNumberBatch x, BigNumberBatch y, BigNumberBatch result);
+void batch_divide_by_limb(BigNumberBatch x, Limb divisor, bool divisor_is_positive, BigNumberBatch result);
+
+int format_batch_lane(BigNumberBatch batch, int lane, char *output);
+char* read_batch_line(BatchReader *reader, size_t *length);
+
+void execute_batch_program();
+
+#endif
@@ -1,8 +1,34 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <limits.h>
 #include "auxiliar.h"
 #include "bignumber.h"
+#include "budget.h"
+#include "fixed_width.h"
+#include "ntt.h"
+#include "storage.h"
+#include "tuning.h"
+
+
+/*
+* @brief Inicializa a biblioteca com a mesma configuração usada pelo cliente.
+*
+* @details Carrega os limiares de troca de algoritmo de get_config_path() (bignumber.conf ou
+*          o arquivo de BIGNUMBER_CONFIG), os limites de BIGNUMBER_MAX_MEMORY_MB e
+*          BIGNUMBER_MAX_SECONDS e o armazenamento em arquivo de BIGNUMBER_STORAGE_DIR.
+*          Sem esta chamada, a biblioteca usa os valores padrão de tuning.h e budget.h.
+*          Deve ser chamada uma vez, antes de qualquer Big Number ser criado.
+*
+* @return false, se o armazenamento em arquivo foi pedido e não pôde ser criado.
+*/
+
+bool initialize_big_number_library() {
+    load_thresholds(get_config_path());
+    load_budget();
+
+    return initialize_storage();
+}
 
 
 /*
@@ -214,7 +240,7 @@ BigNumber divide_big_numbers(BigNumber dividend, BigNumber divisor) {
 
     Node dividend_node = dividend->first_digit;
 
-    while (dividend_node != NULL) {
+    while (dividend_node != NULL && !is_request_cancelled()) {
         add_node_to_big_number(current_dividend, dividend_node->digit, true);
         remove_zeros_from_left(current_dividend);
 
@@ -240,6 +266,8 @@ BigNumber divide_big_numbers(BigNumber dividend, BigNumber divisor) {
 
     free_big_number(current_dividend);
 
+    if (quocient->num_digits == 0) add_node_to_big_number(quocient, 0, true);
+
     quocient->is_positive = result_sign;
     remove_zeros_from_left(quocient);
 
@@ -273,7 +301,7 @@ BigNumber multiply_big_numbers(BigNumber x, BigNumber y) {
 
     Node result_extremity = result->last_digit;
 
-    for (Node i = x->last_digit; i; i = i->prev_digit) {
+    for (Node i = x->last_digit; i && !is_request_cancelled(); i = i->prev_digit) {
         Node current_decimal_magnitude = result_extremity;
 
         for (Node j = y->last_digit; j; j = j->prev_digit) {
@@ -307,13 +335,16 @@ BigNumber multiply_big_numbers(BigNumber x, BigNumber y) {
 *          por si mesma. Se o expoente for ímpar, o resultado é obtido multiplicando-se
 *          a base pelo resultado da exponenciação com o expoente reduzido em 1.
 *          O algoritmo utiliza recursão para realizar os cálculos e libera a memória
-*          alocada dinamicamente para Big Numbers intermediários.
+*          alocada dinamicamente para Big Numbers intermediários. As multiplicações usam
+*          multiply_karatsuba_big_numbers(), que escolhe o algoritmo pelo tamanho.
+*          Se a requisição for cancelada, a recursão é interrompida.
 *
 * @return Big Number resultado da exponenciação.
 */
 
 BigNumber fast_exponentiation(BigNumber base, BigNumber exponent) {
-    if (exponent->first_digit->digit == 0 && exponent->first_digit == exponent->last_digit) {
+    if ((exponent->first_digit->digit == 0 && exponent->first_digit == exponent->last_digit) ||
+        is_request_cancelled()) {
         BigNumber result = create_big_number("");
         add_node_to_big_number(result, 1, true);
         return result;
@@ -323,7 +354,7 @@ BigNumber fast_exponentiation(BigNumber base, BigNumber exponent) {
         BigNumber two = create_big_number("2");
         BigNumber exponent_divided_by_2 = divide_big_numbers(exponent, two);
         BigNumber half_power = fast_exponentiation(base, exponent_divided_by_2);
-        BigNumber result = multiply_big_numbers(half_power, half_power);
+        BigNumber result = multiply_karatsuba_big_numbers(half_power, half_power);
 
         free_big_number(two);
         free_big_number(exponent_divided_by_2);
@@ -336,7 +367,7 @@ BigNumber fast_exponentiation(BigNumber base, BigNumber exponent) {
         BigNumber one = create_big_number("1");
         BigNumber exponent_minus_1 = subtract_big_numbers(exponent, one);
         BigNumber partial_result = fast_exponentiation(base, exponent_minus_1);
-        BigNumber result = multiply_big_numbers(base, partial_result);
+        BigNumber result = multiply_karatsuba_big_numbers(base, partial_result);
 
         free_big_number(one);
         free_big_number(exponent_minus_1);
@@ -357,12 +388,21 @@ BigNumber fast_exponentiation(BigNumber base, BigNumber exponent) {
 *
 * @details A função calcula o resto da divisão utilizando a fórmula: resto = dividendo -
 *          (quociente * divisor). O sinal do resultado é ajustado com base no divisor e
-*          no dividendo, garantindo a consistência matemática.
+*          no dividendo, garantindo a consistência matemática. Quando o divisor é de um
+*          tamanho fixo e primo com 10, o resto é calculado pela redução de Montgomery.
 *
 * @return Big Number resto da divisão.
 */
 
 BigNumber remainder_of_division(BigNumber dividend, BigNumber divisor) {
+    const FixedWidth* width = find_fixed_width(divisor->num_digits);
+
+    if (width != NULL) {
+        BigNumber remainder = remainder_fixed_width_big_numbers(dividend, divisor, width);
+
+        if (remainder != NULL) return remainder;
+    }
+
     bool divisor_sign = divisor->is_positive;
     bool dividend_sign = dividend->is_positive;
 
@@ -398,7 +438,11 @@ BigNumber remainder_of_division(BigNumber dividend, BigNumber divisor) {
 * @details Implementa o algoritmo de Karatsuba para multiplicação eficiente de números.
 *          Divide os números em partes, realiza multiplicações menores e combina os
 *          resultados de forma eficiente. O algoritmo é mais rápido que o método
-*          tradicional para números grandes.
+*          tradicional para números grandes; quando um dos operandos tem até
+*          bignumber_thresholds.karatsuba dígitos, o método tradicional é usado, e quando os dois
+*          têm pelo menos bignumber_thresholds.ntt dígitos, a multiplicação é feita pela NTT. Quando
+*          os dois operandos são do mesmo tamanho fixo (de 256 a 4096 bits), são usados os
+*          algoritmos de tamanho fixo. Os sinais de x e y são restaurados no final.
 *
 * @return Big Number resultado da multiplicação.
 */
@@ -406,12 +450,27 @@ BigNumber remainder_of_division(BigNumber dividend, BigNumber divisor) {
 BigNumber multiply_karatsuba_big_numbers(BigNumber x, BigNumber y) {
     BigNumber result;
 
+    if (is_request_cancelled()) return create_big_number("0");
+
+    bool sign_x = x->is_positive;
+    bool sign_y = y->is_positive;
     bool result_sign = true ? x->is_positive == y->is_positive : false;
 
     x->is_positive = true;
     y->is_positive = true;
 
-    if (x->num_digits <= 3 && y->num_digits <= 3) {
+    int smaller_length = (x->num_digits < y->num_digits) ? x->num_digits : y->num_digits;
+    const FixedWidth* width = find_common_fixed_width(x->num_digits, y->num_digits);
+
+    if (width != NULL) {
+        result = multiply_fixed_width_big_numbers(x, y, width);
+    }
+
+    else if (smaller_length >= bignumber_thresholds.ntt && fits_in_ntt(x->num_digits, y->num_digits)) {
+        result = multiply_ntt_big_numbers(x, y);
+    }
+
+    else if (smaller_length <= bignumber_thresholds.karatsuba) {
         result = multiply_big_numbers(x, y);
     }
 
@@ -469,11 +528,220 @@ BigNumber multiply_karatsuba_big_numbers(BigNumber x, BigNumber y) {
         free_big_number(result_aux);
     }
 
+    x->is_positive = sign_x;
+    y->is_positive = sign_y;
+
     result->is_positive = result_sign;
     return result;
 }
 
 
+/*
+* @brief Calcula o fatorial de um Big Number.
+*
+* @param n Big Number do qual o fatorial será calculado.
+*
+* @details O fatorial é calculado pela fatoração "prime swing": n! = ((n/2)!)^2 * swing(n),
+*          onde o swing é o produto de potências de primos, multiplicadas por uma árvore de
+*          produtos balanceada. Assim, as multiplicações finais são entre operandos de
+*          tamanhos parecidos e aproveitam o Karatsuba.
+*
+* @return Big Number resultado do fatorial, ou NULL se n for negativo ou grande demais.
+*/
+
+BigNumber factorial_big_number(BigNumber n) {
+    long long value;
+
+    if (!big_number_to_long(n, &value) || value < 0 || value > INT_MAX) return NULL;
+
+    int num_primes;
+    long long* primes = list_primes_up_to(value, &num_primes);
+
+    BigNumber result = factorial_by_prime_swing(value, primes, num_primes);
+
+    free(primes);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula o coeficiente binomial C(n, k).
+*
+* @param n Big Number com o tamanho do conjunto.
+* @param k Big Number com o tamanho do subconjunto.
+*
+* @details O expoente de cada primo p em C(n, k) é obtido pela fórmula de Legendre,
+*          somando n / p^i - k / p^i - (n - k) / p^i. Cada potência resultante é no máximo n,
+*          e todas são multiplicadas por uma árvore de produtos balanceada, sem nenhuma divisão.
+*
+* @return Big Number resultado do binomial (0 se k < 0 ou k > n), ou NULL se n for
+*         negativo ou grande demais.
+*/
+
+BigNumber binomial_big_numbers(BigNumber n, BigNumber k) {
+    long long value_n, value_k;
+
+    if (!big_number_to_long(n, &value_n) || value_n < 0 || value_n > INT_MAX) return NULL;
+
+    if (!big_number_to_long(k, &value_k) || value_k < 0 || value_k > value_n) {
+        return create_big_number("0");
+    }
+
+    if (value_k > value_n - value_k) value_k = value_n - value_k;
+
+    int num_primes;
+    long long* primes = list_primes_up_to(value_n, &num_primes);
+    long long* factors = malloc(sizeof(long long) * (num_primes + 1));
+    int count = 0;
+
+    for (int i = 0; i < num_primes; i++) {
+        long long p = primes[i];
+        long long power = 1;
+
+        for (long long p_power = p; p_power <= value_n; p_power *= p) {
+            long long exponent = value_n / p_power - value_k / p_power - (value_n - value_k) / p_power;
+
+            for (long long e = 0; e < exponent; e++) power *= p;
+
+            if (p_power > value_n / p) break;
+        }
+
+        if (power > 1) factors[count++] = power;
+    }
+
+    BigNumber result = multiply_list_of_factors(factors, count);
+
+    free(primes);
+    free(factors);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula o produto de todos os inteiros no intervalo [begin, end].
+*
+* @param begin Big Number com o início do intervalo.
+* @param end Big Number com o fim do intervalo.
+*
+* @details Os fatores são multiplicados por uma árvore de produtos balanceada. Se o
+*          intervalo contém o zero, o resultado é zero; se for vazio (begin > end), o
+*          resultado é 1. O sinal é negativo quando há uma quantidade ímpar de fatores negativos.
+*          Intervalos com mais de PRODUCT_OF_RANGE_MAX_FACTORS fatores são recusados, mesmo
+*          fora de apply_operation(), já que o vetor de fatores é alocado de uma vez.
+*
+* @return Big Number resultado do produto, ou NULL se o intervalo for grande demais.
+*/
+
+BigNumber product_of_range(BigNumber begin, BigNumber end) {
+    long long value_begin, value_end;
+
+    if (!big_number_to_long(begin, &value_begin) || !big_number_to_long(end, &value_end)) return NULL;
+    if (value_begin > value_end) return create_big_number("1");
+    if (value_begin <= 0 && value_end >= 0) return create_big_number("0");
+    if (value_end - value_begin >= PRODUCT_OF_RANGE_MAX_FACTORS) return NULL;
+
+    int count = value_end - value_begin + 1;
+    long long* factors = malloc(sizeof(long long) * count);
+
+    for (int i = 0; i < count; i++) {
+        long long factor = value_begin + i;
+        factors[i] = (factor < 0) ? -factor : factor;
+    }
+
+    BigNumber result = multiply_list_of_factors(factors, count);
+
+    result->is_positive = (value_end < 0 && count % 2 == 1) ? false : true;
+
+    free(factors);
+
+    return result;
+}
+
+
+/*
+* @brief Soma uma lista de Big Numbers.
+*
+* @param numbers Vetor de Big Numbers a serem somados.
+* @param count Quantidade de Big Numbers no vetor.
+*
+* @details Em vez de encadear várias chamadas de sum_big_numbers, os dígitos de todos os
+*          números são acumulados em colunas largas (carry-save), separando os termos
+*          positivos dos negativos. O transporte é propagado uma única vez no final.
+*
+* @return Big Number resultado da soma (0 se a lista for vazia).
+*/
+
+BigNumber sum_many_big_numbers(BigNumber *numbers, int count) {
+    int length = 2;
+
+    for (int i = 0; i < count; i++) {
+        if (numbers[i]->num_digits + 20 > length) length = numbers[i]->num_digits + 20;
+    }
+
+    long long* positive_columns = allocate_storage_array(sizeof(long long) * length, true);
+    long long* negative_columns = allocate_storage_array(sizeof(long long) * length, true);
+
+    for (int i = 0; i < count; i++) {
+        accumulate_big_number(numbers[i]->is_positive ? positive_columns : negative_columns, numbers[i]);
+    }
+
+    BigNumber result = combine_signed_columns(positive_columns, negative_columns, length);
+
+    release_storage_array(positive_columns, sizeof(long long) * length);
+    release_storage_array(negative_columns, sizeof(long long) * length);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula o produto escalar entre duas listas de Big Numbers.
+*
+* @param x Vetor de Big Numbers.
+* @param y Vetor de Big Numbers, com o mesmo tamanho de x.
+* @param count Quantidade de pares.
+*
+* @details Calcula x[0] * y[0] + x[1] * y[1] + ... acumulando cada produto diretamente
+*          em colunas largas (carry-save), sem criar Big Numbers intermediários para os
+*          produtos pequenos. O transporte é propagado uma única vez no final.
+*
+* @return Big Number resultado do produto escalar (0 se a lista for vazia).
+*/
+
+BigNumber dot_product_big_numbers(BigNumber *x, BigNumber *y, int count) {
+    int length = 2;
+
+    for (int i = 0; i < count; i++) {
+        int product_length = x[i]->num_digits + y[i]->num_digits + 20;
+
+        if (product_length > length) length = product_length;
+    }
+
+    long long* positive_columns = allocate_storage_array(sizeof(long long) * length, true);
+    long long* negative_columns = allocate_storage_array(sizeof(long long) * length, true);
+
+    for (int i = 0; i < count; i++) {
+        bool sign_x = x[i]->is_positive;
+        bool sign_y = y[i]->is_positive;
+
+        long long* columns = (sign_x == sign_y) ? positive_columns : negative_columns;
+        accumulate_product_of_big_numbers(columns, x[i], y[i]);
+
+        x[i]->is_positive = sign_x;
+        y[i]->is_positive = sign_y;
+    }
+
+    BigNumber result = combine_signed_columns(positive_columns, negative_columns, length);
+
+    release_storage_array(positive_columns, sizeof(long long) * length);
+    release_storage_array(negative_columns, sizeof(long long) * length);
+
+    return result;
+}
+
+
 /*
 * @brief Realiza o print de um Big Number.
 *
@@ -481,16 +749,36 @@ BigNumber multiply_karatsuba_big_numbers(BigNumber x, BigNumber y) {
 */
 
 void print_big_number(BigNumber big_number) {
-    if ((big_number->is_positive == false)) printf("-");
+    fprint_big_number(stdout, big_number);
+}
+
+
+/*
+* @brief Realiza o print de um Big Number em um arquivo.
+*
+* @param output Arquivo onde o Big Number será escrito.
+* @param big_number Big Number a ser printado.
+*
+* @details Os dígitos são montados em um buffer e escritos com uma única chamada.
+*/
+
+void fprint_big_number(FILE *output, BigNumber big_number) {
+    char* text = malloc(big_number->num_digits + 3);
+    int length = 0;
+
+    if ((big_number->is_positive == false)) text[length++] = '-';
 
     Node current_node = big_number->first_digit;
 
     while (current_node != NULL) {
-        printf("%d", current_node->digit);
+        text[length++] = '0' + current_node->digit;
         current_node = current_node->next_digit;
     }
 
-    printf("\n");
+    text[length++] = '\n';
+
+    fwrite(text, 1, length, output);
+    free(text);
 }
 
 
@@ -501,13 +789,7 @@ void print_big_number(BigNumber big_number) {
 */
 
 void free_big_number(BigNumber big_number) {
-    Node current_node = big_number->first_digit;
-
-    while (current_node != NULL) {
-        Node next_node = current_node->next_digit;
-        free(current_node);
-        current_node = next_node;
-    }
+    release_node_list(big_number->first_digit, big_number->last_digit, big_number->num_digits);
 
     free(big_number);
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef bignumber_h
 #define bignumber_h
 
+#include <stdio.h>
 #include <stdbool.h>
 
 typedef struct Node {
@@ -17,16 +18,30 @@ typedef struct BigNumber {
     Node last_digit;
 }* BigNumber;
 
+bool initialize_big_number_library();
+
 BigNumber create_big_number(char *str_number);
 BigNumber sum_big_numbers(BigNumber x, BigNumber y);
 BigNumber subtract_big_numbers(BigNumber x, BigNumber y);
 BigNumber divide_big_numbers(BigNumber dividend, BigNumber divisor);
+BigNumber divexact_big_numbers(BigNumber dividend, BigNumber divisor);
 BigNumber multiply_big_numbers(BigNumber x, BigNumber y);
 BigNumber fast_exponentiation(BigNumber base, BigNumber exponent);
 BigNumber remainder_of_division(BigNumber dividend, BigNumber divisor);
 BigNumber multiply_karatsuba_big_numbers(BigNumber x, BigNumber y);
+BigNumber multiply_ntt_big_numbers(BigNumber x, BigNumber y);
+BigNumber factorial_big_number(BigNumber n);
+BigNumber binomial_big_numbers(BigNumber n, BigNumber k);
+BigNumber product_of_range(BigNumber begin, BigNumber end);
+BigNumber sum_many_big_numbers(BigNumber *numbers, int count);
+BigNumber dot_product_big_numbers(BigNumber *x, BigNumber *y, int count);
+long long count_digits_of_result(char operation, BigNumber x, BigNumber y);
+BigNumber leading_digits_of_result(char operation, BigNumber x, BigNumber y, int k);
+BigNumber trailing_digits_of_result(char operation, BigNumber x, BigNumber y, int k);
+const char* check_partial_result_budget(char operation, BigNumber x, BigNumber y, int k, bool is_trailing);
 
 void print_big_number(BigNumber x);
+void fprint_big_number(FILE *output, BigNumber x);
 void free_big_number(BigNumber x);
 
 #endif
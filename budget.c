@@ -0,0 +1,398 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "auxiliar.h"
+#include "bignumber.h"
+#include "budget.h"
+#include "fixed_width.h"
+#include "tuning.h"
+
+
+Budget bignumber_budget = {DEFAULT_MAX_MEMORY_MB, DEFAULT_MAX_SECONDS};
+
+static __thread RequestState current_request = NULL;
+
+
+/*
+* @brief Carrega os limites de cada requisição a partir do ambiente.
+*
+* @details BIGNUMBER_MAX_MEMORY_MB limita a memória estimada do resultado e
+*          BIGNUMBER_MAX_SECONDS limita o tempo de execução. O valor 0 desativa o limite.
+*/
+
+void load_budget() {
+    const char* max_memory = getenv("BIGNUMBER_MAX_MEMORY_MB");
+    const char* max_seconds = getenv("BIGNUMBER_MAX_SECONDS");
+
+    if (max_memory != NULL && *max_memory != '\0') bignumber_budget.max_memory_mb = atof(max_memory);
+    if (max_seconds != NULL && *max_seconds != '\0') bignumber_budget.max_seconds = atof(max_seconds);
+}
+
+
+/*
+* @brief Estima o logaritmo na base 10 do módulo de um Big Number.
+*
+* @param x Big Number.
+*
+* @details Usa apenas os 15 primeiros dígitos e a quantidade total de dígitos.
+*
+* @return Estimativa de log10(|x|), ou -1 se x for zero.
+*/
+
+double estimate_log10(BigNumber x) {
+    double leading = 0;
+    int used_digits = 0;
+
+    for (Node node = x->first_digit; node != NULL && used_digits < 15; node = node->next_digit) {
+        leading = leading * 10 + node->digit;
+        used_digits++;
+    }
+
+    if (leading == 0) return -1;
+
+    return log10(leading) + (x->num_digits - used_digits);
+}
+
+
+/*
+* @brief Estima quantos dígitos o resultado de uma operação terá.
+*
+* @param operation Caractere da operação.
+* @param x Primeiro operando.
+* @param y Segundo operando.
+*
+* @details A estimativa é feita sem executar a operação: soma dos tamanhos para '*',
+*          logaritmos para '^' e a função lgamma para fatorial, binomial e produto de intervalo.
+*
+* @return Quantidade estimada de dígitos (pode ser infinita).
+*/
+
+double estimate_result_digits(char operation, BigNumber x, BigNumber y) {
+    double digits_x = x->num_digits;
+    double digits_y = y->num_digits;
+    double value_x = pow(10, estimate_log10(x));
+    double value_y = pow(10, estimate_log10(y));
+
+    switch (operation) {
+        case '+':
+        case '-':
+            return fmax(digits_x, digits_y) + 1;
+        case '*':
+        case 'x':
+            return digits_x + digits_y;
+        case '/':
+        case 'E':
+            return fmax(digits_x - digits_y + 1, 1);
+        case '%':
+            return digits_y;
+        case '^': {
+            double log_base = estimate_log10(x);
+
+            if (log_base <= 0 || !y->is_positive) return 1;
+
+            return floor(value_y * log_base) + 1;
+        }
+        case '!':
+            return (x->is_positive && value_x > 1) ? floor(lgamma(value_x + 1) / log(10)) + 1 : 1;
+        case 'C': {
+            double n = value_x;
+            double k = fmin(value_y, n - value_y);
+
+            if (!x->is_positive || !y->is_positive || k < 1) return 1;
+
+            return floor((lgamma(n + 1) - lgamma(k + 1) - lgamma(n - k + 1)) / log(10)) + 1;
+        }
+        case 'P': {
+            double begin = x->is_positive ? value_x : -value_x;
+            double end = y->is_positive ? value_y : -value_y;
+            double largest = fmax(fabs(begin), fabs(end));
+
+            if (end < begin) return 1;
+
+            return floor((end - begin + 1) * log10(fmax(largest, 2))) + 1;
+        }
+        default:
+            return 1;
+    }
+}
+
+
+/*
+* @brief Estima o custo de uma multiplicação, em operações com dígitos.
+*
+* @param num_digits_x Quantidade de dígitos do primeiro operando.
+* @param num_digits_y Quantidade de dígitos do segundo operando.
+*
+* @details Segue a mesma escolha de algoritmo de multiply_karatsuba_big_numbers(). No
+*          tamanho fixo, o custo é o produto de todos os limbs mais as conversões.
+*/
+
+double estimate_multiplication_cost(double num_digits_x, double num_digits_y) {
+    double smaller = fmin(num_digits_x, num_digits_y);
+    double larger = fmax(num_digits_x, num_digits_y);
+    double total = num_digits_x + num_digits_y;
+
+    if (larger <= FIXED_WIDTH_MAX_LIMBS * LIMB_DIGITS) {
+        const FixedWidth* width = find_common_fixed_width((int) num_digits_x, (int) num_digits_y);
+
+        if (width != NULL) return (double) width->limbs * width->limbs + 2 * total;
+    }
+
+    if (smaller <= bignumber_thresholds.karatsuba) return num_digits_x * num_digits_y;
+    if (smaller >= bignumber_thresholds.ntt) return 4 * total * log2(total);
+
+    return pow(total / 2, 1.585) * 4;
+}
+
+
+/*
+* @brief Estima o custo de uma operação, em operações com dígitos.
+*
+* @param operation Caractere da operação.
+* @param x Primeiro operando.
+* @param y Segundo operando.
+*
+* @return Custo estimado (pode ser infinito).
+*/
+
+double estimate_operation_cost(char operation, BigNumber x, BigNumber y) {
+    double digits_x = x->num_digits;
+    double digits_y = y->num_digits;
+    double digits_result = estimate_result_digits(operation, x, y);
+
+    switch (operation) {
+        case '*':
+            return estimate_multiplication_cost(digits_x, digits_y);
+        case 'x':
+            return digits_x * digits_y;
+        case '/':
+            return 10 * fmax(digits_x - digits_y + 1, 1) * digits_y;
+        case 'E':
+            return fmax(digits_x - digits_y + 1, 1) * digits_y;
+        case '%':
+            return 10 * fmax(digits_x - digits_y + 1, 1) * digits_y + digits_x * digits_y;
+        case '^':
+            return 2 * estimate_multiplication_cost(digits_result / 2, digits_result / 2) +
+                   digits_x * digits_result * log2(fmax(digits_result, 2));
+        case '!':
+        case 'C':
+        case 'P':
+            return estimate_multiplication_cost(digits_result / 2, digits_result / 2) * log2(fmax(digits_result, 2));
+        default:
+            return digits_x + digits_y;
+    }
+}
+
+
+/*
+* @brief Estima a memória usada por uma operação além dos Nós do resultado, em bytes.
+*
+* @param operation Caractere da operação.
+* @param x Primeiro operando.
+* @param y Segundo operando.
+*
+* @details Fatorial e binomial usam o crivo de list_primes_up_to(), com 1 byte por inteiro
+*          até n e o vetor de primos (até n / 2 inteiros de 8 bytes), mesmo quando o
+*          resultado é pequeno. O produto de intervalo guarda um fator de 8 bytes por
+*          inteiro do intervalo.
+*
+* @return Memória estimada (pode ser infinita).
+*/
+
+static double estimate_auxiliary_memory(char operation, BigNumber x, BigNumber y) {
+    double value_x = pow(10, estimate_log10(x));
+    double value_y = pow(10, estimate_log10(y));
+
+    switch (operation) {
+        case '!':
+        case 'C':
+            return x->is_positive ? 5 * value_x : 0;
+        case 'P': {
+            double begin = x->is_positive ? value_x : -value_x;
+            double end = y->is_positive ? value_y : -value_y;
+
+            if (end < begin || (begin <= 0 && end >= 0)) return 0;
+
+            return 8 * (end - begin + 1);
+        }
+        default:
+            return 0;
+    }
+}
+
+
+/*
+* @brief Compara uma estimativa de memória e de custo com os limites de uma requisição.
+*
+* @param memory_bytes Memória estimada, em bytes.
+* @param cost Custo estimado, em operações com dígitos.
+*
+* @return Mensagem de erro, ou NULL se a estimativa cabe nos limites.
+*/
+
+const char* check_budget_limits(double memory_bytes, double cost) {
+    double memory_mb = memory_bytes / (1024.0 * 1024.0);
+
+    if (bignumber_budget.max_memory_mb > 0 && !(memory_mb <= bignumber_budget.max_memory_mb)) {
+        return "Requisição excede o limite de memória";
+    }
+
+    double seconds = cost / DIGIT_OPERATIONS_PER_SECOND;
+
+    if (bignumber_budget.max_seconds > 0 && !(seconds <= bignumber_budget.max_seconds)) {
+        return "Requisição excede o limite de tempo";
+    }
+
+    return NULL;
+}
+
+
+/*
+* @brief Verifica, antes de executar, se uma operação cabe nos limites de uma requisição.
+*
+* @param operation Caractere da operação.
+* @param x Primeiro operando.
+* @param y Segundo operando.
+*
+* @details A memória é estimada pela quantidade de dígitos do resultado, o tamanho de cada
+*          Nó e uma folga para os valores intermediários, mais a memória auxiliar da
+*          operação (veja estimate_auxiliary_memory()). O tempo é estimado pelo custo
+*          em operações com dígitos.
+*
+* @return Mensagem de erro, ou NULL se a operação pode ser executada.
+*/
+
+const char* check_budget(char operation, BigNumber x, BigNumber y) {
+    double digits = estimate_result_digits(operation, x, y);
+    double memory = digits * sizeof(struct Node) * MEMORY_OVERHEAD_FACTOR + estimate_auxiliary_memory(operation, x, y);
+    double cost = estimate_operation_cost(operation, x, y);
+
+    if (operation == '!' || operation == 'C') cost += pow(10, estimate_log10(x));
+
+    return check_budget_limits(memory, cost);
+}
+
+
+/*
+* @brief Verifica se uma soma ou um produto escalar de vários termos cabe nos limites.
+*
+* @param x Vetor com os termos (ou os primeiros fatores, no produto escalar).
+* @param y Vetor com os segundos fatores, ou NULL para uma soma.
+* @param count Quantidade de termos.
+*
+* @details A memória conta as duas colunas largas de sum_many_big_numbers() e
+*          dot_product_big_numbers() e os Nós do resultado. O custo é a soma do
+*          custo de acumular cada termo.
+*
+* @return Mensagem de erro, ou NULL se a operação pode ser executada.
+*/
+
+const char* check_terms_budget(BigNumber *x, BigNumber *y, int count) {
+    double length = 2;
+    double cost = 0;
+
+    for (int i = 0; i < count; i++) {
+        double term_length = x[i]->num_digits + ((y != NULL) ? y[i]->num_digits : 0) + 20;
+
+        length = fmax(length, term_length);
+        cost += (y != NULL) ? estimate_multiplication_cost(x[i]->num_digits, y[i]->num_digits) : x[i]->num_digits;
+    }
+
+    double memory = 2 * length * sizeof(long long) + length * sizeof(struct Node) * MEMORY_OVERHEAD_FACTOR;
+
+    return check_budget_limits(memory, cost + length);
+}
+
+
+/*
+* @brief Quantidade máxima de dígitos de um número que ainda cabe no limite de memória.
+*
+* @return A quantidade de dígitos, ou 0 se não houver limite de memória.
+*/
+
+size_t get_max_digits_in_budget() {
+    if (bignumber_budget.max_memory_mb <= 0) return 0;
+
+    return bignumber_budget.max_memory_mb * 1024 * 1024 / (sizeof(struct Node) * MEMORY_OVERHEAD_FACTOR);
+}
+
+
+/*
+* @brief Retorna a requisição sendo executada pela thread atual (ou NULL).
+*/
+
+RequestState get_current_request() {
+    return current_request;
+}
+
+
+/*
+* @brief Define a requisição da thread atual.
+*
+* @param request Requisição (ou NULL).
+*
+* @details Usada pelo pool de threads para que as tarefas de uma requisição respeitem
+*          o mesmo prazo e o mesmo cancelamento.
+*/
+
+void set_current_request(RequestState request) {
+    current_request = request;
+}
+
+
+/*
+* @brief Inicia uma requisição na thread atual.
+*
+* @param request Estado da requisição, mantido pelo chamador até end_request().
+* @param max_seconds Tempo máximo da requisição (0 para não ter limite).
+*/
+
+void begin_request(RequestState request, double max_seconds) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    request->deadline = (max_seconds > 0) ? now.tv_sec + now.tv_nsec / 1e9 + max_seconds : 0;
+    request->is_cancelled = false;
+
+    current_request = request;
+}
+
+
+/*
+* @brief Encerra a requisição da thread atual.
+*/
+
+void end_request() {
+    current_request = NULL;
+}
+
+
+/*
+* @brief Ponto de verificação de cancelamento para os algoritmos demorados.
+*
+* @details Quando o prazo da requisição atual passa, ela é marcada como cancelada. Os
+*          algoritmos que chamam esta função param assim que possível, devolvendo um
+*          resultado qualquer, que é descartado por apply_operation().
+*
+* @return true, se a requisição atual foi cancelada.
+*/
+
+bool is_request_cancelled() {
+    RequestState request = current_request;
+
+    if (request == NULL) return false;
+    if (request->is_cancelled) return true;
+    if (request->deadline == 0) return false;
+
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if (now.tv_sec + now.tv_nsec / 1e9 > request->deadline) request->is_cancelled = true;
+
+    return request->is_cancelled;
+}
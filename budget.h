@@ -0,0 +1,42 @@
+#ifndef budget_h
+#define budget_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "bignumber.h"
+
+#define DEFAULT_MAX_MEMORY_MB 1024
+#define DEFAULT_MAX_SECONDS 0
+#define MEMORY_OVERHEAD_FACTOR 3
+#define DIGIT_OPERATIONS_PER_SECOND 2e7
+
+typedef struct Budget {
+    double max_memory_mb;
+    double max_seconds;
+} Budget;
+
+typedef struct RequestState {
+    double deadline;
+    volatile bool is_cancelled;
+}* RequestState;
+
+extern Budget bignumber_budget;
+
+void load_budget();
+
+double estimate_log10(BigNumber x);
+double estimate_result_digits(char operation, BigNumber x, BigNumber y);
+double estimate_multiplication_cost(double num_digits_x, double num_digits_y);
+double estimate_operation_cost(char operation, BigNumber x, BigNumber y);
+const char* check_budget_limits(double memory_bytes, double cost);
+const char* check_budget(char operation, BigNumber x, BigNumber y);
+const char* check_terms_budget(BigNumber *x, BigNumber *y, int count);
+size_t get_max_digits_in_budget();
+
+RequestState get_current_request();
+void set_current_request(RequestState request);
+void begin_request(RequestState request, double max_seconds);
+void end_request();
+bool is_request_cancelled();
+
+#endif
@@ -1,7 +1,36 @@
+#include <string.h>
 #include "auxiliar.h"
+#include "batch.h"
+#include "server.h"
+#include "tuning.h"
+#include "wire.h"
 
-int main() {
-    execute_program();
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--tune") == 0) {
+        return run_tuning((argc > 2) ? argv[2] : get_config_path());
+    }
+
+    if (!initialize_big_number_library()) return 1;
+
+    if (argc > 1 && strcmp(argv[1], "--binary") == 0) {
+        execute_binary_program(0, 1);
+    }
+
+    else if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        execute_batch_program();
+    }
+
+    else if (argc > 1 && strcmp(argv[1], "--hex") == 0) {
+        execute_hex_program();
+    }
+
+    else if (argc > 2 && strcmp(argv[1], "--server") == 0) {
+        return run_server(argv[2]);
+    }
+
+    else {
+        execute_program();
+    }
 
     return 0;
 }
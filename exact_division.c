@@ -0,0 +1,218 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bignumber.h"
+#include "budget.h"
+#include "exact_division.h"
+#include "limbs.h"
+#include "storage.h"
+
+#define CHECK_PRIME 4294967291u
+
+
+/*
+* @brief Divide um vetor de limbs por um número pequeno, do limb mais significativo para o menos.
+*
+* @param limbs Vetor de limbs, alterado para o quociente.
+* @param count Quantidade de limbs, atualizada para o tamanho do quociente.
+* @param divisor Divisor, entre 1 e 10^9.
+*
+* @return Resto da divisão.
+*/
+
+static Limb divide_limbs_by_small(Limb *limbs, int *count, Limb divisor) {
+    uint64_t remainder = 0;
+
+    for (int i = *count - 1; i >= 0; i--) {
+        uint64_t value = remainder * LIMB_BASE + limbs[i];
+
+        limbs[i] = value / divisor;
+        remainder = value % divisor;
+    }
+
+    *count = normalize_limbs_length(limbs, *count);
+
+    return remainder;
+}
+
+
+/*
+* @brief Retira do divisor (e do dividendo) todos os fatores de um primo que divide 10.
+*
+* @param dividend Limbs do dividendo.
+* @param count_dividend Quantidade de limbs do dividendo.
+* @param divisor Limbs do divisor.
+* @param count_divisor Quantidade de limbs do divisor.
+* @param prime 2 ou 5.
+*
+* @details Como 10^9 = 2^9 * 5^9, o limb menos significativo diz quantos fatores (até 9)
+*          saem em cada divisão curta, então cada passada remove até 2^9 ou 5^9 de uma vez.
+*/
+
+static void remove_factors_of_base(Limb *dividend, int *count_dividend, Limb *divisor, int *count_divisor, Limb prime) {
+    while (divisor[0] % prime == 0) {
+        Limb power = prime;
+
+        for (int k = 1; k < LIMB_DIGITS && divisor[0] % (power * prime) == 0; k++) power *= prime;
+
+        divide_limbs_by_small(dividend, count_dividend, power);
+        divide_limbs_by_small(divisor, count_divisor, power);
+    }
+}
+
+
+/*
+* @brief Calcula o resto de um vetor de limbs por CHECK_PRIME, para a verificação do resultado.
+*/
+
+static uint64_t limbs_modulo_check_prime(const Limb *limbs, int count) {
+    uint64_t remainder = 0;
+
+    for (int i = count - 1; i >= 0; i--) remainder = (remainder * LIMB_BASE + limbs[i]) % CHECK_PRIME;
+
+    return remainder;
+}
+
+
+/*
+* @brief Divide exatamente dois vetores de limbs, no lugar.
+*
+* @param dividend Limbs do dividendo, múltiplo do divisor; recebe o quociente.
+* @param count_dividend Quantidade de limbs do dividendo (normalizada).
+* @param divisor Limbs do divisor, diferente de zero; é alterado.
+* @param count_divisor Quantidade de limbs do divisor (normalizada).
+*
+* @details Usa a divisão exata de Jebelean, que calcula o quociente a partir dos limbs menos
+*          significativos: depois de retirar do divisor os fatores 2 e 5 (que não são
+*          invertíveis módulo 10^9) por divisões curtas, cada limb do quociente é o limb atual
+*          do dividendo vezes o inverso do limb menos significativo do divisor, e só os limbs
+*          que ainda formam o quociente são atualizados. Não há estimativas nem correções,
+*          como na divisão comum, e nenhuma memória é alocada. No final, os restos do
+*          dividendo e de quociente * divisor por um primo de 32 bits são comparados: se
+*          forem diferentes, o dividendo não era múltiplo do divisor.
+*
+* @return Quantidade de limbs do quociente, ou -1 se a divisão não for exata.
+*/
+
+int divide_exact_limbs(Limb *dividend, int count_dividend, Limb *divisor, int count_divisor) {
+    Limb* a = dividend;
+    Limb* b = divisor;
+    int count_a = count_dividend;
+    int count_b = count_divisor;
+
+    uint64_t residue_a = limbs_modulo_check_prime(a, count_a);
+    uint64_t residue_b = limbs_modulo_check_prime(b, count_b);
+
+    int shift = 0;
+
+    while (b[shift] == 0) shift++;
+
+    if (shift > 0) {
+        if (count_a > shift) {
+            count_a -= shift;
+            memmove(a, a + shift, sizeof(Limb) * count_a);
+        }
+
+        else {
+            a[0] = 0;
+            count_a = 1;
+        }
+
+        count_b -= shift;
+        memmove(b, b + shift, sizeof(Limb) * count_b);
+    }
+
+    remove_factors_of_base(a, &count_a, b, &count_b, 2);
+    remove_factors_of_base(a, &count_a, b, &count_b, 5);
+
+    int count_quotient = count_a - count_b + 1;
+    if (count_quotient <= 0) {
+        a[0] = 0;
+        count_quotient = 1;
+    }
+
+    else {
+        Limb inverse = inverse_of_limb(b[0]);
+
+        for (int i = 0; i < count_quotient && !is_request_cancelled(); i++) {
+            Limb q = (uint64_t) a[i] * inverse % LIMB_BASE;
+            uint64_t carry = 0;
+
+            for (int j = 0; j < count_b && i + j < count_quotient; j++) {
+                uint64_t product = (uint64_t) q * b[j] + carry;
+                Limb low = product % LIMB_BASE;
+
+                carry = product / LIMB_BASE;
+
+                if (a[i + j] < low) {
+                    a[i + j] += LIMB_BASE - low;
+                    carry++;
+                }
+
+                else {
+                    a[i + j] -= low;
+                }
+            }
+
+            for (int k = i + count_b; k < count_quotient && carry > 0; k++) {
+                Limb low = carry % LIMB_BASE;
+
+                carry /= LIMB_BASE;
+
+                if (a[k] < low) {
+                    a[k] += LIMB_BASE - low;
+                    carry++;
+                }
+
+                else {
+                    a[k] -= low;
+                }
+            }
+
+            a[i] = q;
+        }
+    }
+
+    if (!is_request_cancelled() && residue_a != limbs_modulo_check_prime(a, count_quotient) * residue_b % CHECK_PRIME) {
+        return -1;
+    }
+
+    return normalize_limbs_length(a, count_quotient);
+}
+
+
+/*
+* @brief Divide dois Big Numbers quando a divisão é sabidamente exata.
+*
+* @param dividend Big Number dividendo, múltiplo do divisor.
+* @param divisor Big Number divisor.
+*
+* @details Converte os operandos para limbs e usa divide_exact_limbs().
+*
+* @return Big Number quociente da divisão, ou NULL se o divisor for zero ou se o dividendo
+*         não for múltiplo do divisor.
+*/
+
+BigNumber divexact_big_numbers(BigNumber dividend, BigNumber divisor) {
+    if (divisor->num_digits == 1 && divisor->first_digit->digit == 0) return NULL;
+
+    size_t size_a = sizeof(Limb) * limbs_length_for_digits(dividend->num_digits);
+    size_t size_b = sizeof(Limb) * limbs_length_for_digits(divisor->num_digits);
+
+    Limb* a = allocate_storage_array(size_a, true);
+    Limb* b = allocate_storage_array(size_b, true);
+
+    int count_a = big_number_to_limbs(dividend, a);
+    int count_b = big_number_to_limbs(divisor, b);
+    int count_quotient = divide_exact_limbs(a, count_a, b, count_b);
+    BigNumber result = NULL;
+
+    if (count_quotient > 0) {
+        result = create_big_number_from_limbs(a, count_quotient, dividend->is_positive == divisor->is_positive);
+    }
+
+    release_storage_array(a, size_a);
+    release_storage_array(b, size_b);
+
+    return result;
+}
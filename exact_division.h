@@ -0,0 +1,8 @@
+#ifndef exact_division_h
+#define exact_division_h
+
+#include "limbs.h"
+
+int divide_exact_limbs(Limb *dividend, int count_dividend, Limb *divisor, int count_divisor);
+
+#endif
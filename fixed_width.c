@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bignumber.h"
+#include "fixed_width.h"
+#include "limbs.h"
+#include "tuning.h"
+
+
+/*
+* Gera os algoritmos de tamanho fixo para operandos de LIMBS limbs de base 10^9.
+*
+* Como a quantidade de limbs é uma constante em cada versão, os laços têm tamanho
+* conhecido em tempo de compilação e são desenrolados pelo compilador, e todos os
+* valores intermediários ficam na pilha, sem nenhuma alocação.
+*
+*   multiply_fixed_LIMBS:           result (2 * LIMBS limbs) = x * y.
+*   square_fixed_LIMBS:             result (2 * LIMBS limbs) = x * x, calculando cada
+*                                   produto cruzado uma única vez.
+*   montgomery_reduce_fixed_LIMBS:  result (LIMBS limbs) = t * R^-1 mod modulus, com
+*                                   R = (10^9)^LIMBS, t < modulus * R (2 * LIMBS + 1 limbs,
+*                                   alterado) e modulus_inverse = -modulus^-1 mod 10^9.
+*/
+
+#define DEFINE_FIXED_WIDTH_KERNELS(LIMBS)                                                       \
+                                                                                                \
+static void multiply_fixed_##LIMBS(Limb *result, const Limb *x, const Limb *y) {                \
+    memset(result, 0, sizeof(Limb) * 2 * LIMBS);                                                \
+                                                                                                \
+    for (int i = 0; i < LIMBS; i++) {                                                           \
+        uint64_t carry = 0;                                                                     \
+                                                                                                \
+        for (int j = 0; j < LIMBS; j++) {                                                       \
+            uint64_t value = result[i + j] + (uint64_t) x[i] * y[j] + carry;                    \
+                                                                                                \
+            result[i + j] = value % LIMB_BASE;                                                  \
+            carry = value / LIMB_BASE;                                                          \
+        }                                                                                       \
+                                                                                                \
+        result[i + LIMBS] = carry;                                                              \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+static void square_fixed_##LIMBS(Limb *result, const Limb *x) {                                 \
+    memset(result, 0, sizeof(Limb) * 2 * LIMBS);                                                \
+                                                                                                \
+    for (int i = 0; i < LIMBS; i++) {                                                           \
+        uint64_t carry = 0;                                                                     \
+                                                                                                \
+        for (int j = i + 1; j < LIMBS; j++) {                                                   \
+            uint64_t value = result[i + j] + (uint64_t) x[i] * x[j] + carry;                    \
+                                                                                                \
+            result[i + j] = value % LIMB_BASE;                                                  \
+            carry = value / LIMB_BASE;                                                          \
+        }                                                                                       \
+                                                                                                \
+        result[i + LIMBS] = carry;                                                              \
+    }                                                                                           \
+                                                                                                \
+    uint64_t carry = 0;                                                                         \
+                                                                                                \
+    for (int k = 0; k < 2 * LIMBS; k++) {                                                       \
+        uint64_t value = 2 * (uint64_t) result[k] + carry;                                      \
+                                                                                                \
+        result[k] = value % LIMB_BASE;                                                          \
+        carry = value / LIMB_BASE;                                                              \
+    }                                                                                           \
+                                                                                                \
+    carry = 0;                                                                                  \
+                                                                                                \
+    for (int k = 0; k < LIMBS; k++) {                                                           \
+        uint64_t value = result[2 * k] + (uint64_t) x[k] * x[k] + carry;                        \
+                                                                                                \
+        result[2 * k] = value % LIMB_BASE;                                                      \
+        value = result[2 * k + 1] + value / LIMB_BASE;                                          \
+        result[2 * k + 1] = value % LIMB_BASE;                                                  \
+        carry = value / LIMB_BASE;                                                              \
+    }                                                                                           \
+}                                                                                               \
+                                                                                                \
+static void montgomery_reduce_fixed_##LIMBS(Limb *result, Limb *t, const Limb *modulus,        \
+                                            Limb modulus_inverse) {                             \
+    for (int i = 0; i < LIMBS; i++) {                                                           \
+        uint64_t u = (uint64_t) t[i] * modulus_inverse % LIMB_BASE;                             \
+        uint64_t carry = 0;                                                                     \
+                                                                                                \
+        for (int j = 0; j < LIMBS; j++) {                                                       \
+            uint64_t value = t[i + j] + u * modulus[j] + carry;                                 \
+                                                                                                \
+            t[i + j] = value % LIMB_BASE;                                                       \
+            carry = value / LIMB_BASE;                                                          \
+        }                                                                                       \
+                                                                                                \
+        for (int k = i + LIMBS; k <= 2 * LIMBS && carry > 0; k++) {                             \
+            uint64_t value = t[k] + carry;                                                      \
+                                                                                                \
+            t[k] = value % LIMB_BASE;                                                           \
+            carry = value / LIMB_BASE;                                                          \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    bool is_greater_or_equal = t[2 * LIMBS] > 0;                                                \
+                                                                                                \
+    if (!is_greater_or_equal) {                                                                 \
+        is_greater_or_equal = true;                                                             \
+                                                                                                \
+        for (int k = LIMBS - 1; k >= 0; k--) {                                                  \
+            if (t[LIMBS + k] != modulus[k]) {                                                   \
+                is_greater_or_equal = t[LIMBS + k] > modulus[k];                                \
+                break;                                                                          \
+            }                                                                                   \
+        }                                                                                       \
+    }                                                                                           \
+                                                                                                \
+    int64_t borrow = 0;                                                                         \
+                                                                                                \
+    for (int k = 0; k < LIMBS; k++) {                                                           \
+        int64_t value = (int64_t) t[LIMBS + k] - (is_greater_or_equal ? modulus[k] : 0) - borrow; \
+                                                                                                \
+        borrow = value < 0;                                                                     \
+        result[k] = value + borrow * (int64_t) LIMB_BASE;                                       \
+    }                                                                                           \
+}
+
+DEFINE_FIXED_WIDTH_KERNELS(9)
+DEFINE_FIXED_WIDTH_KERNELS(18)
+DEFINE_FIXED_WIDTH_KERNELS(35)
+DEFINE_FIXED_WIDTH_KERNELS(69)
+DEFINE_FIXED_WIDTH_KERNELS(138)
+
+
+static const FixedWidth fixed_widths[] = {
+    {256, 9, multiply_fixed_9, square_fixed_9, montgomery_reduce_fixed_9},
+    {512, 18, multiply_fixed_18, square_fixed_18, montgomery_reduce_fixed_18},
+    {1024, 35, multiply_fixed_35, square_fixed_35, montgomery_reduce_fixed_35},
+    {2048, 69, multiply_fixed_69, square_fixed_69, montgomery_reduce_fixed_69},
+    {4096, 138, multiply_fixed_138, square_fixed_138, montgomery_reduce_fixed_138}
+};
+
+static const int num_fixed_widths = sizeof(fixed_widths) / sizeof(fixed_widths[0]);
+
+
+typedef struct MontgomeryCache {
+    int limbs;
+    Limb modulus[FIXED_WIDTH_MAX_LIMBS];
+    Limb r_squared[FIXED_WIDTH_MAX_LIMBS];
+    Limb modulus_inverse;
+    bool is_ready;
+} MontgomeryCache;
+
+static __thread MontgomeryCache montgomery_cache = {0, {0}, {0}, 0, false};
+
+
+/*
+* @brief Encontra o tamanho fixo de uma quantidade de dígitos.
+*
+* @param num_digits Quantidade de dígitos decimais.
+*
+* @details Cada tamanho fixo atende só os números que ocupam quase todos os seus limbs
+*          (os últimos FIXED_WIDTH_WINDOW_LIMBS limbs; por exemplo, 2048 bits atende de 604 a
+*          621 dígitos), já que os algoritmos de tamanho fixo sempre percorrem todos os limbs
+*          e, para números menores, o Karatsuba e a NTT continuam sendo a melhor escolha.
+*          Tamanhos acima de bignumber_thresholds.fixed_width_bits não são usados.
+*
+* @return O tamanho fixo, ou NULL se o número não estiver perto de nenhum tamanho fixo.
+*/
+
+const FixedWidth* find_fixed_width(int num_digits) {
+    for (int i = 0; i < num_fixed_widths && fixed_widths[i].bits <= bignumber_thresholds.fixed_width_bits; i++) {
+        int lower_limit = (fixed_widths[i].limbs - FIXED_WIDTH_WINDOW_LIMBS) * LIMB_DIGITS;
+
+        if (num_digits > lower_limit && num_digits <= fixed_widths[i].limbs * LIMB_DIGITS) return &fixed_widths[i];
+    }
+
+    return NULL;
+}
+
+
+/*
+* @brief Encontra o tamanho fixo comum a dois operandos.
+*
+* @param num_digits_x Quantidade de dígitos do primeiro operando.
+* @param num_digits_y Quantidade de dígitos do segundo operando.
+*
+* @return O tamanho fixo, ou NULL se os operandos não forem do mesmo tamanho fixo.
+*/
+
+const FixedWidth* find_common_fixed_width(int num_digits_x, int num_digits_y) {
+    const FixedWidth* width = find_fixed_width(num_digits_x);
+
+    return (width != NULL && width == find_fixed_width(num_digits_y)) ? width : NULL;
+}
+
+
+/*
+* @brief Converte um Big Number para exatamente width->limbs limbs, completando com zeros.
+*/
+
+static void big_number_to_fixed_limbs(BigNumber x, Limb *limbs, const FixedWidth *width) {
+    int count = big_number_to_limbs(x, limbs);
+
+    for (int i = count; i < width->limbs; i++) limbs[i] = 0;
+}
+
+
+/*
+* @brief Multiplica dois Big Numbers com os algoritmos de tamanho fixo.
+*
+* @param x Big Number a ser multiplicado.
+* @param y Big Number a ser multiplicado.
+* @param width Tamanho fixo comum aos dois operandos (veja find_common_fixed_width()).
+*
+* @details Quando x e y são o mesmo Big Number, usa o quadrado, que calcula cada produto
+*          cruzado uma única vez.
+*
+* @return Big Number resultado da multiplicação.
+*/
+
+BigNumber multiply_fixed_width_big_numbers(BigNumber x, BigNumber y, const FixedWidth *width) {
+    Limb limbs_x[FIXED_WIDTH_MAX_LIMBS];
+    Limb limbs_y[FIXED_WIDTH_MAX_LIMBS];
+    Limb product[2 * FIXED_WIDTH_MAX_LIMBS];
+
+    big_number_to_fixed_limbs(x, limbs_x, width);
+
+    if (x == y) {
+        width->square(product, limbs_x);
+    }
+
+    else {
+        big_number_to_fixed_limbs(y, limbs_y, width);
+        width->multiply(product, limbs_x, limbs_y);
+    }
+
+    return create_big_number_from_limbs(product, 2 * width->limbs, x->is_positive == y->is_positive);
+}
+
+
+/*
+* @brief Prepara as constantes de Montgomery de um módulo.
+*
+* @param modulus Limbs do módulo (ímpar e não divisível por 5).
+* @param width Tamanho fixo do módulo.
+*
+* @details Calcula -modulus^-1 mod 10^9 (veja inverse_of_limb()) e R^2 mod modulus
+*          por uma divisão comum. As constantes ficam guardadas por thread
+*          e só são calculadas quando o mesmo módulo aparece em duas chamadas seguidas, já
+*          que o cálculo custa tanto quanto um resto comum.
+*
+* @return true se as constantes estão prontas, false se o módulo ainda não se repetiu.
+*/
+
+static bool prepare_montgomery_cache(const Limb *modulus, const FixedWidth *width) {
+    MontgomeryCache* cache = &montgomery_cache;
+
+    if (cache->limbs != width->limbs || compare_limbs(cache->modulus, modulus, width->limbs) != 0) {
+        memcpy(cache->modulus, modulus, sizeof(Limb) * width->limbs);
+        cache->limbs = width->limbs;
+        cache->is_ready = false;
+
+        return false;
+    }
+
+    if (cache->is_ready) return true;
+
+    cache->modulus_inverse = (LIMB_BASE - inverse_of_limb(modulus[0])) % LIMB_BASE;
+
+    int r_squared_digits = 2 * width->limbs * LIMB_DIGITS;
+    char* str_r_squared = malloc(r_squared_digits + 2);
+
+    str_r_squared[0] = '1';
+    memset(str_r_squared + 1, '0', r_squared_digits);
+    str_r_squared[r_squared_digits + 1] = '\0';
+
+    BigNumber r_squared = create_big_number(str_r_squared);
+    BigNumber big_modulus = create_big_number_from_limbs(modulus, width->limbs, true);
+    BigNumber quocient = divide_big_numbers(r_squared, big_modulus);
+    BigNumber quocient_times_modulus = multiply_karatsuba_big_numbers(quocient, big_modulus);
+    BigNumber remainder = subtract_big_numbers(r_squared, quocient_times_modulus);
+
+    big_number_to_fixed_limbs(remainder, cache->r_squared, width);
+    cache->is_ready = true;
+
+    free(str_r_squared);
+    free_big_number(r_squared);
+    free_big_number(big_modulus);
+    free_big_number(quocient);
+    free_big_number(quocient_times_modulus);
+    free_big_number(remainder);
+
+    return true;
+}
+
+
+/*
+* @brief Calcula o resto da divisão pela redução de Montgomery de tamanho fixo.
+*
+* @param dividend Big Number dividendo, com no máximo 2 * width->limbs limbs.
+* @param divisor Big Number divisor positivo, do tamanho fixo "width".
+* @param width Tamanho fixo do divisor.
+*
+* @details Com R = (10^9)^n, o resto é REDC(REDC(dividendo) * (R^2 mod divisor)). Só se
+*          aplica quando o divisor é primo com 10 (ímpar e não terminado em 5) e o
+*          dividendo é maior que o divisor e menor que divisor * R. O sinal segue
+*          remainder_of_division().
+*
+* @return Big Number resto da divisão, ou NULL se o caso não for atendido (inclusive na
+*         primeira vez que o divisor aparece; veja prepare_montgomery_cache()).
+*/
+
+BigNumber remainder_fixed_width_big_numbers(BigNumber dividend, BigNumber divisor, const FixedWidth *width) {
+    int last_digit = divisor->last_digit->digit;
+
+    if (!divisor->is_positive || last_digit % 2 == 0 || last_digit == 5) return NULL;
+    if (dividend->num_digits < divisor->num_digits) return NULL;
+    if (dividend->num_digits > 2 * width->limbs * LIMB_DIGITS) return NULL;
+
+    Limb modulus[FIXED_WIDTH_MAX_LIMBS];
+    Limb t[2 * FIXED_WIDTH_MAX_LIMBS + 1];
+    Limb reduced[FIXED_WIDTH_MAX_LIMBS];
+
+    big_number_to_fixed_limbs(divisor, modulus, width);
+
+    int count = big_number_to_limbs(dividend, t);
+
+    for (int i = count; i <= 2 * width->limbs; i++) t[i] = 0;
+
+    if (compare_limbs(t + width->limbs, modulus, width->limbs) >= 0) return NULL;
+    if (!prepare_montgomery_cache(modulus, width)) return NULL;
+
+    width->montgomery_reduce(reduced, t, modulus, montgomery_cache.modulus_inverse);
+    width->multiply(t, reduced, montgomery_cache.r_squared);
+    t[2 * width->limbs] = 0;
+    width->montgomery_reduce(reduced, t, modulus, montgomery_cache.modulus_inverse);
+
+    int reduced_count = normalize_limbs_length(reduced, width->limbs);
+    bool is_zero = reduced_count == 1 && reduced[0] == 0;
+
+    if (!dividend->is_positive && !is_zero) {
+        int64_t borrow = 0;
+
+        for (int k = 0; k < width->limbs; k++) {
+            int64_t difference = (int64_t) modulus[k] - reduced[k] - borrow;
+
+            borrow = difference < 0;
+            reduced[k] = difference + borrow * (int64_t) LIMB_BASE;
+        }
+    }
+
+    return create_big_number_from_limbs(reduced, width->limbs, true);
+}
@@ -0,0 +1,24 @@
+#ifndef fixed_width_h
+#define fixed_width_h
+
+#include "bignumber.h"
+#include "limbs.h"
+
+#define FIXED_WIDTH_MAX_LIMBS 138
+#define FIXED_WIDTH_WINDOW_LIMBS 2
+
+typedef struct FixedWidth {
+    int bits;
+    int limbs;
+    void (*multiply)(Limb *result, const Limb *x, const Limb *y);
+    void (*square)(Limb *result, const Limb *x);
+    void (*montgomery_reduce)(Limb *result, Limb *t, const Limb *modulus, Limb modulus_inverse);
+} FixedWidth;
+
+const FixedWidth* find_fixed_width(int num_digits);
+const FixedWidth* find_common_fixed_width(int num_digits_x, int num_digits_y);
+
+BigNumber multiply_fixed_width_big_numbers(BigNumber x, BigNumber y, const FixedWidth *width);
+BigNumber remainder_fixed_width_big_numbers(BigNumber dividend, BigNumber divisor, const FixedWidth *width);
+
+#endif
@@ -0,0 +1,758 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "auxiliar.h"
+#include "bignumber.h"
+#include "exact_division.h"
+#include "fixed_width.h"
+#include "limb_buffer.h"
+#include "limbs.h"
+
+
+/*
+* Interface para quem usa a aritmética como biblioteca, com números em buffers de limbs
+* fornecidos pelo chamador (na pilha, em pools ou reaproveitados entre requisições).
+* Nenhuma função deste arquivo aloca memória, exceto as de conversão de e para Big Number:
+* o chamador consulta o tamanho necessário do resultado (e da área de rascunho, quando
+* existe) com as funções "_size" e passa buffers com pelo menos essa capacidade. As
+* funções devolvem um dos códigos LIMB_BUFFER_*.
+*/
+
+
+/*
+* @brief Inicializa um buffer com a memória do chamador, valendo zero.
+*
+* @param buffer Buffer a ser inicializado.
+* @param limbs Memória com pelo menos "capacity" limbs (e pelo menos 1).
+* @param capacity Quantidade de limbs disponíveis.
+*/
+
+void init_limb_buffer(LimbBuffer *buffer, Limb *limbs, int capacity) {
+    buffer->limbs = limbs;
+    buffer->capacity = capacity;
+    buffer->count = 1;
+    buffer->is_positive = true;
+
+    limbs[0] = 0;
+}
+
+
+/*
+* @brief Ajusta a quantidade de limbs e o sinal de um buffer depois de uma operação.
+*
+* @details Remove os limbs zerados mais significativos e deixa o zero sempre positivo.
+*/
+
+static void normalize_limb_buffer(LimbBuffer *buffer, int count, bool is_positive) {
+    buffer->count = normalize_limbs_length(buffer->limbs, count);
+    buffer->is_positive = (buffer->count == 1 && buffer->limbs[0] == 0) ? true : is_positive;
+}
+
+
+/*
+* @brief Quantidade de limbs necessária para um número com num_digits dígitos.
+*/
+
+int limb_buffer_limbs_for_digits(int num_digits) {
+    return limbs_length_for_digits(num_digits);
+}
+
+
+/*
+* @brief Lê um número decimal (com '-' opcional) para um buffer.
+*
+* @param result Buffer de destino, com pelo menos limb_buffer_limbs_for_digits(strlen) limbs.
+* @param str_number String do número.
+*
+* @return LIMB_BUFFER_OK, LIMB_BUFFER_INVALID_INPUT se a string não for um número ou
+*         LIMB_BUFFER_TOO_SMALL se o número não couber no buffer.
+*/
+
+int limb_buffer_from_string(LimbBuffer *result, const char *str_number) {
+    bool is_positive = *str_number != '-';
+
+    if (!is_positive) str_number++;
+
+    while (*str_number == '0' && str_number[1] != '\0') str_number++;
+
+    int num_digits = strlen(str_number);
+
+    if (num_digits == 0) return LIMB_BUFFER_INVALID_INPUT;
+
+    for (int i = 0; i < num_digits; i++) {
+        if (str_number[i] < '0' || str_number[i] > '9') return LIMB_BUFFER_INVALID_INPUT;
+    }
+
+    int count = limbs_length_for_digits(num_digits);
+
+    if (count > result->capacity) return LIMB_BUFFER_TOO_SMALL;
+
+    for (int i = 0; i < count; i++) {
+        int end = num_digits - i * LIMB_DIGITS;
+        int begin = (end > LIMB_DIGITS) ? end - LIMB_DIGITS : 0;
+        Limb limb = 0;
+
+        for (int j = begin; j < end; j++) limb = limb * 10 + (str_number[j] - '0');
+
+        result->limbs[i] = limb;
+    }
+
+    normalize_limb_buffer(result, count, is_positive);
+
+    return LIMB_BUFFER_OK;
+}
+
+
+/*
+* @brief Tamanho, em bytes, da string de um buffer (incluindo o sinal e o '\0').
+*/
+
+int limb_buffer_string_size(const LimbBuffer *x) {
+    int top_digits = 1;
+
+    for (Limb top = x->limbs[x->count - 1]; top >= 10; top /= 10) top_digits++;
+
+    return (x->count - 1) * LIMB_DIGITS + top_digits + (x->is_positive ? 0 : 1) + 1;
+}
+
+
+/*
+* @brief Escreve um buffer como string decimal.
+*
+* @param x Buffer a ser escrito.
+* @param output Destino, com pelo menos "size" bytes.
+* @param size Tamanho do destino (veja limb_buffer_string_size()).
+*
+* @return LIMB_BUFFER_OK ou LIMB_BUFFER_TOO_SMALL.
+*/
+
+int limb_buffer_to_string(const LimbBuffer *x, char *output, int size) {
+    int length = limb_buffer_string_size(x);
+
+    if (length > size) return LIMB_BUFFER_TOO_SMALL;
+
+    int position = length - 1;
+    output[position] = '\0';
+
+    for (int i = 0; i < x->count; i++) {
+        Limb limb = x->limbs[i];
+        bool is_top = i == x->count - 1;
+
+        for (int j = 0; j < LIMB_DIGITS && (!is_top || j == 0 || limb > 0); j++) {
+            output[--position] = '0' + limb % 10;
+            limb /= 10;
+        }
+    }
+
+    if (!x->is_positive) output[0] = '-';
+
+    return LIMB_BUFFER_OK;
+}
+
+
+/*
+* @brief Copia um Big Number para um buffer.
+*
+* @return LIMB_BUFFER_OK ou LIMB_BUFFER_TOO_SMALL.
+*/
+
+int limb_buffer_from_big_number(LimbBuffer *result, BigNumber x) {
+    if (limbs_length_for_digits(x->num_digits) > result->capacity) return LIMB_BUFFER_TOO_SMALL;
+
+    normalize_limb_buffer(result, big_number_to_limbs(x, result->limbs), x->is_positive);
+
+    return LIMB_BUFFER_OK;
+}
+
+
+/*
+* @brief Cria um Big Number (alocado, como os de bignumber.h) com o valor de um buffer.
+*/
+
+BigNumber limb_buffer_to_big_number(const LimbBuffer *x) {
+    return create_big_number_from_limbs(x->limbs, x->count, x->is_positive);
+}
+
+
+/*
+* @brief Limite superior de limbs da soma (ou subtração) de dois buffers.
+*/
+
+int sum_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y) {
+    return ((x->count > y->count) ? x->count : y->count) + 1;
+}
+
+
+/*
+* @brief Limite superior de limbs do produto de dois buffers.
+*/
+
+int multiply_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y) {
+    return x->count + y->count;
+}
+
+
+/*
+* @brief Limite superior de limbs do quociente de dois buffers.
+*/
+
+int quotient_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y) {
+    return (x->count >= y->count) ? x->count - y->count + 1 : 1;
+}
+
+
+/*
+* @brief Limite superior de limbs do resto da divisão de dois buffers.
+*/
+
+int remainder_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y) {
+    (void) x;
+
+    return y->count;
+}
+
+
+/*
+* @brief Quantidade de limbs de rascunho usados por divide_limb_buffers().
+*/
+
+int divide_limb_buffers_scratch_size(const LimbBuffer *x, const LimbBuffer *y) {
+    return x->count + 1 + y->count;
+}
+
+
+/*
+* @brief Quantidade de limbs de rascunho usados por divexact_limb_buffers().
+*/
+
+int divexact_limb_buffers_scratch_size(const LimbBuffer *x, const LimbBuffer *y) {
+    return x->count + y->count;
+}
+
+
+/*
+* @brief Compara os módulos de dois vetores de limbs normalizados.
+*
+* @return 1, 0 ou -1, como compare_big_numbers_modules().
+*/
+
+static int compare_limbs_modules(const Limb *x, int count_x, const Limb *y, int count_y) {
+    if (count_x != count_y) return (count_x > count_y) ? 1 : -1;
+
+    return compare_limbs(x, y, count_x);
+}
+
+
+/*
+* @brief Soma os módulos de dois vetores de limbs.
+*
+* @details O resultado pode ser o mesmo vetor que x ou y, já que cada limb é lido antes
+*          de ser escrito.
+*
+* @return Quantidade de limbs escritos (max(count_x, count_y) + 1).
+*/
+
+static int add_limbs_modules(Limb *result, const Limb *x, int count_x, const Limb *y, int count_y) {
+    int count = (count_x > count_y) ? count_x : count_y;
+    Limb carry = 0;
+
+    for (int i = 0; i < count; i++) {
+        Limb value = ((i < count_x) ? x[i] : 0) + ((i < count_y) ? y[i] : 0) + carry;
+
+        carry = value >= LIMB_BASE;
+        result[i] = value - carry * LIMB_BASE;
+    }
+
+    result[count] = carry;
+
+    return count + 1;
+}
+
+
+/*
+* @brief Subtrai os módulos de dois vetores de limbs, com |x| >= |y|.
+*
+* @details O resultado pode ser o mesmo vetor que x ou y.
+*
+* @return Quantidade de limbs escritos (count_x).
+*/
+
+static int subtract_limbs_modules(Limb *result, const Limb *x, int count_x, const Limb *y, int count_y) {
+    int64_t borrow = 0;
+
+    for (int i = 0; i < count_x; i++) {
+        int64_t value = (int64_t) x[i] - ((i < count_y) ? y[i] : 0) - borrow;
+
+        borrow = value < 0;
+        result[i] = value + borrow * (int64_t) LIMB_BASE;
+    }
+
+    return count_x;
+}
+
+
+/*
+* @brief Soma ou subtrai dois buffers, conforme os sinais.
+*
+* @param negate_y Se verdadeiro, calcula x - y.
+*/
+
+static int add_signed_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y, bool negate_y) {
+    bool sign_x = x->is_positive;
+    bool sign_y = negate_y ? !y->is_positive : y->is_positive;
+
+    if (sum_limb_buffers_size(x, y) > result->capacity) return LIMB_BUFFER_TOO_SMALL;
+
+    if (sign_x == sign_y) {
+        normalize_limb_buffer(result, add_limbs_modules(result->limbs, x->limbs, x->count, y->limbs, y->count), sign_x);
+    }
+
+    else if (compare_limbs_modules(x->limbs, x->count, y->limbs, y->count) >= 0) {
+        normalize_limb_buffer(result, subtract_limbs_modules(result->limbs, x->limbs, x->count, y->limbs, y->count), sign_x);
+    }
+
+    else {
+        normalize_limb_buffer(result, subtract_limbs_modules(result->limbs, y->limbs, y->count, x->limbs, x->count), sign_y);
+    }
+
+    return LIMB_BUFFER_OK;
+}
+
+
+/*
+* @brief Soma dois buffers.
+*
+* @param result Buffer do resultado, com pelo menos sum_limb_buffers_size() limbs; pode
+*               ser o mesmo que x ou y.
+*
+* @return LIMB_BUFFER_OK ou LIMB_BUFFER_TOO_SMALL.
+*/
+
+int sum_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y) {
+    return add_signed_limb_buffers(result, x, y, false);
+}
+
+
+/*
+* @brief Subtrai dois buffers (x - y).
+*
+* @param result Buffer do resultado, com pelo menos sum_limb_buffers_size() limbs; pode
+*               ser o mesmo que x ou y.
+*
+* @return LIMB_BUFFER_OK ou LIMB_BUFFER_TOO_SMALL.
+*/
+
+int subtract_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y) {
+    return add_signed_limb_buffers(result, x, y, true);
+}
+
+
+/*
+* @brief Multiplica os módulos de dois vetores de limbs pelo método tradicional.
+*
+* @param result Vetor com count_x + count_y limbs, diferente de x e y.
+*/
+
+static void multiply_limbs_schoolbook(Limb *result, const Limb *x, int count_x, const Limb *y, int count_y) {
+    memset(result, 0, sizeof(Limb) * (count_x + count_y));
+
+    for (int i = 0; i < count_x; i++) {
+        uint64_t carry = 0;
+
+        for (int j = 0; j < count_y; j++) {
+            uint64_t value = result[i + j] + (uint64_t) x[i] * y[j] + carry;
+
+            result[i + j] = value % LIMB_BASE;
+            carry = value / LIMB_BASE;
+        }
+
+        result[i + count_y] = carry;
+    }
+}
+
+
+/*
+* @brief Soma um vetor de limbs em outro, a partir do começo, propagando o vai-um.
+*
+* @param result Vetor com "count" limbs, alterado.
+* @param x Vetor a ser somado, com "count_x" limbs; os limbs que passam de "count" devem ser zero.
+*/
+
+static void add_limbs_into(Limb *result, int count, const Limb *x, int count_x) {
+    Limb carry = 0;
+
+    for (int i = 0; i < count && (i < count_x || carry > 0); i++) {
+        Limb value = result[i] + ((i < count_x) ? x[i] : 0) + carry;
+
+        carry = value >= LIMB_BASE;
+        result[i] = value - carry * LIMB_BASE;
+    }
+}
+
+
+/*
+* @brief Limite superior de limbs de rascunho usados por multiply_limbs_karatsuba().
+*
+* @details Cada nível da recursão usa no máximo 4h + 4 limbs (as somas das metades e o
+*          produto do meio), com h a metade do maior operando, e o próximo nível recebe
+*          operandos de no máximo h + 1 limbs; a soma desses termos limita o total.
+*/
+
+static int karatsuba_limbs_scratch_size(int count_x, int count_y) {
+    int larger = (count_x > count_y) ? count_x : count_y;
+    int smaller = (count_x > count_y) ? count_y : count_x;
+    int total = 0;
+
+    if (smaller < LIMB_KARATSUBA_THRESHOLD) return 0;
+
+    for (int n = larger; n >= LIMB_KARATSUBA_THRESHOLD; n = (n + 1) / 2 + 1) {
+        total += 4 * ((n + 1) / 2) + 4;
+    }
+
+    return total;
+}
+
+
+/*
+* @brief Multiplica os módulos de dois vetores de limbs pelo algoritmo de Karatsuba.
+*
+* @param result Vetor com count_x + count_y limbs, diferente de x e y.
+* @param scratch Rascunho com pelo menos karatsuba_limbs_scratch_size() limbs.
+*
+* @details Com h a metade do maior operando, x = x1 * B^h + x0 e y = y1 * B^h + y0; os
+*          produtos x0 * y0 e x1 * y1 vão direto para o resultado e o do meio,
+*          (x0 + x1)(y0 + y1) - x0 * y0 - x1 * y1, é calculado no rascunho e somado na
+*          posição h. Quando o menor operando não passa de h limbs, o maior é dividido em
+*          blocos do tamanho do menor. Abaixo de LIMB_KARATSUBA_THRESHOLD limbs, usa o
+*          método tradicional.
+*/
+
+static void multiply_limbs_karatsuba(Limb *result, const Limb *x, int count_x, const Limb *y, int count_y, Limb *scratch) {
+    if (count_x < count_y) {
+        const Limb* swap = x;
+        int swap_count = count_x;
+
+        x = y; count_x = count_y;
+        y = swap; count_y = swap_count;
+    }
+
+    if (count_y < LIMB_KARATSUBA_THRESHOLD) {
+        multiply_limbs_schoolbook(result, x, count_x, y, count_y);
+        return;
+    }
+
+    int half = (count_x + 1) / 2;
+
+    if (count_y <= half) {
+        Limb* product = scratch;
+
+        memset(result, 0, sizeof(Limb) * (count_x + count_y));
+
+        for (int offset = 0; offset < count_x; offset += count_y) {
+            int length = (count_x - offset < count_y) ? count_x - offset : count_y;
+
+            multiply_limbs_karatsuba(product, x + offset, length, y, count_y, scratch + 2 * count_y);
+            add_limbs_into(result + offset, count_x + count_y - offset, product, length + count_y);
+        }
+
+        return;
+    }
+
+    Limb* sum_x = scratch;
+    Limb* sum_y = scratch + half + 1;
+    Limb* middle = scratch + 2 * half + 2;
+
+    multiply_limbs_karatsuba(result, x, half, y, half, scratch);
+    multiply_limbs_karatsuba(result + 2 * half, x + half, count_x - half, y + half, count_y - half, scratch);
+
+    add_limbs_modules(sum_x, x, half, x + half, count_x - half);
+    add_limbs_modules(sum_y, y, half, y + half, count_y - half);
+
+    multiply_limbs_karatsuba(middle, sum_x, half + 1, sum_y, half + 1, scratch + 4 * half + 4);
+
+    subtract_limbs_modules(middle, middle, 2 * half + 2, result, 2 * half);
+    subtract_limbs_modules(middle, middle, 2 * half + 2, result + 2 * half, count_x + count_y - 2 * half);
+
+    add_limbs_into(result + half, count_x + count_y - half, middle, 2 * half + 2);
+}
+
+
+/*
+* @brief Quantidade de limbs de rascunho usados por multiply_limb_buffers().
+*/
+
+int multiply_limb_buffers_scratch_size(const LimbBuffer *x, const LimbBuffer *y) {
+    if (find_common_fixed_width(x->count * LIMB_DIGITS, y->count * LIMB_DIGITS) != NULL) return 0;
+
+    return karatsuba_limbs_scratch_size(x->count, y->count);
+}
+
+
+/*
+* @brief Multiplica dois buffers.
+*
+* @param result Buffer do resultado, com pelo menos multiply_limb_buffers_size() limbs;
+*               não pode ser o mesmo que x ou y.
+* @param scratch Área de rascunho com pelo menos multiply_limb_buffers_scratch_size() limbs
+*                (pode ser NULL quando esse tamanho é zero).
+* @param scratch_size Quantidade de limbs da área de rascunho.
+*
+* @details Quando os dois operandos são de um tamanho fixo (de 256 a 4096 bits), usa os
+*          algoritmos de tamanho fixo, com os operandos completados na pilha; senão, usa
+*          Karatsuba no rascunho do chamador, que cai no método tradicional abaixo de
+*          LIMB_KARATSUBA_THRESHOLD limbs.
+*
+* @return LIMB_BUFFER_OK, LIMB_BUFFER_TOO_SMALL ou LIMB_BUFFER_SCRATCH_TOO_SMALL.
+*/
+
+int multiply_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y, Limb *scratch, int scratch_size) {
+    int count = multiply_limb_buffers_size(x, y);
+
+    if (count > result->capacity) return LIMB_BUFFER_TOO_SMALL;
+    if (scratch_size < multiply_limb_buffers_scratch_size(x, y)) return LIMB_BUFFER_SCRATCH_TOO_SMALL;
+
+    const FixedWidth* width = find_common_fixed_width(x->count * LIMB_DIGITS, y->count * LIMB_DIGITS);
+
+    if (width != NULL) {
+        Limb limbs_x[FIXED_WIDTH_MAX_LIMBS] = {0};
+        Limb limbs_y[FIXED_WIDTH_MAX_LIMBS] = {0};
+        Limb product[2 * FIXED_WIDTH_MAX_LIMBS];
+
+        memcpy(limbs_x, x->limbs, sizeof(Limb) * x->count);
+        memcpy(limbs_y, y->limbs, sizeof(Limb) * y->count);
+
+        if (x == y) width->square(product, limbs_x);
+        else width->multiply(product, limbs_x, limbs_y);
+
+        memcpy(result->limbs, product, sizeof(Limb) * count);
+    }
+
+    else {
+        multiply_limbs_karatsuba(result->limbs, x->limbs, x->count, y->limbs, y->count, scratch);
+    }
+
+    normalize_limb_buffer(result, count, x->is_positive == y->is_positive);
+
+    return LIMB_BUFFER_OK;
+}
+
+
+/*
+* @brief Multiplica um vetor de limbs por um limb, no lugar.
+*
+* @return O limb que transbordou.
+*/
+
+static Limb multiply_limbs_by_small(Limb *limbs, int count, Limb factor) {
+    uint64_t carry = 0;
+
+    for (int i = 0; i < count; i++) {
+        uint64_t value = (uint64_t) limbs[i] * factor + carry;
+
+        limbs[i] = value % LIMB_BASE;
+        carry = value / LIMB_BASE;
+    }
+
+    return carry;
+}
+
+
+/*
+* @brief Divide um vetor de limbs por um limb, no lugar, do mais significativo para o menos.
+*
+* @return O resto.
+*/
+
+static Limb divide_limbs_by_limb(Limb *limbs, int count, Limb divisor) {
+    uint64_t remainder = 0;
+
+    for (int i = count - 1; i >= 0; i--) {
+        uint64_t value = remainder * LIMB_BASE + limbs[i];
+
+        limbs[i] = value / divisor;
+        remainder = value % divisor;
+    }
+
+    return remainder;
+}
+
+
+/*
+* @brief Divide os módulos u (count_u + 1 limbs) e v (count_v >= 2 limbs), já normalizados.
+*
+* @details Algoritmo D de Knuth na base 10^9: com o limb mais significativo de v pelo menos
+*          10^9 / 2, cada limb do quociente é estimado pelos dois limbs mais significativos
+*          do resto parcial e corrigido no máximo duas vezes. O resto fica em u[0..count_v-1]
+*          e o quociente (count_u - count_v + 1 limbs) vai para "quotient", se não for NULL.
+*/
+
+static void divide_limbs_modules(Limb *quotient, Limb *u, int count_u, const Limb *v, int count_v) {
+    for (int j = count_u - count_v; j >= 0; j--) {
+        uint64_t numerator = (uint64_t) u[j + count_v] * LIMB_BASE + u[j + count_v - 1];
+        uint64_t q_hat = numerator / v[count_v - 1];
+        uint64_t r_hat = numerator % v[count_v - 1];
+
+        while (q_hat >= LIMB_BASE || q_hat * v[count_v - 2] > r_hat * LIMB_BASE + u[j + count_v - 2]) {
+            q_hat--;
+            r_hat += v[count_v - 1];
+
+            if (r_hat >= LIMB_BASE) break;
+        }
+
+        uint64_t carry = 0;
+        int64_t borrow = 0;
+
+        for (int i = 0; i < count_v; i++) {
+            uint64_t product = q_hat * v[i] + carry;
+            int64_t value = (int64_t) u[i + j] - (int64_t) (product % LIMB_BASE) - borrow;
+
+            carry = product / LIMB_BASE;
+            borrow = value < 0;
+            u[i + j] = value + borrow * (int64_t) LIMB_BASE;
+        }
+
+        int64_t top = (int64_t) u[j + count_v] - (int64_t) carry - borrow;
+
+        if (top < 0) {
+            Limb add_carry = 0;
+
+            q_hat--;
+
+            for (int i = 0; i < count_v; i++) {
+                Limb value = u[i + j] + v[i] + add_carry;
+
+                add_carry = value >= LIMB_BASE;
+                u[i + j] = value - add_carry * LIMB_BASE;
+            }
+
+            top += add_carry;
+        }
+
+        u[j + count_v] = top;
+
+        if (quotient != NULL) quotient[j] = q_hat;
+    }
+}
+
+
+/*
+* @brief Divide dois buffers, com os mesmos resultados de divide_big_numbers() e remainder_of_division().
+*
+* @param quotient Buffer do quociente (com pelo menos quotient_limb_buffers_size() limbs), ou NULL.
+* @param remainder Buffer do resto (com pelo menos remainder_limb_buffers_size() limbs), ou NULL.
+* @param x Dividendo.
+* @param y Divisor.
+* @param scratch Área de rascunho com pelo menos divide_limb_buffers_scratch_size() limbs.
+* @param scratch_size Quantidade de limbs da área de rascunho.
+*
+* @details O quociente é truncado em direção ao zero e o resto tem o sinal do divisor. Os
+*          operandos são copiados para o rascunho antes de qualquer escrita, então quociente
+*          e resto podem ser os mesmos buffers que x ou y.
+*
+* @return LIMB_BUFFER_OK, LIMB_BUFFER_TOO_SMALL, LIMB_BUFFER_SCRATCH_TOO_SMALL ou
+*         LIMB_BUFFER_INVALID_INPUT (divisão por zero).
+*/
+
+int divide_limb_buffers(LimbBuffer *quotient, LimbBuffer *remainder, const LimbBuffer *x, const LimbBuffer *y,
+                        Limb *scratch, int scratch_size) {
+    int count_x = x->count;
+    int count_y = y->count;
+    int count_quotient = quotient_limb_buffers_size(x, y);
+    bool sign_x = x->is_positive;
+    bool sign_y = y->is_positive;
+
+    if (count_y == 1 && y->limbs[0] == 0) return LIMB_BUFFER_INVALID_INPUT;
+    if (scratch_size < divide_limb_buffers_scratch_size(x, y)) return LIMB_BUFFER_SCRATCH_TOO_SMALL;
+    if (quotient != NULL && count_quotient > quotient->capacity) return LIMB_BUFFER_TOO_SMALL;
+    if (remainder != NULL && count_y > remainder->capacity) return LIMB_BUFFER_TOO_SMALL;
+
+    Limb* u = scratch;
+    Limb* v = scratch + count_x + 1;
+
+    memcpy(u, x->limbs, sizeof(Limb) * count_x);
+    memcpy(v, y->limbs, sizeof(Limb) * count_y);
+    u[count_x] = 0;
+
+    Limb* quotient_limbs = (quotient != NULL) ? quotient->limbs : NULL;
+    int count_remainder;
+
+    if (count_x < count_y) {
+        if (quotient_limbs != NULL) quotient_limbs[0] = 0;
+        count_remainder = count_x;
+    }
+
+    else if (count_y == 1) {
+        Limb short_remainder = divide_limbs_by_limb(u, count_x, v[0]);
+
+        if (quotient_limbs != NULL) memcpy(quotient_limbs, u, sizeof(Limb) * count_quotient);
+
+        u[0] = short_remainder;
+        count_remainder = 1;
+    }
+
+    else {
+        Limb factor = LIMB_BASE / (v[count_y - 1] + 1);
+
+        u[count_x] = multiply_limbs_by_small(u, count_x, factor);
+        multiply_limbs_by_small(v, count_y, factor);
+
+        divide_limbs_modules(quotient_limbs, u, count_x, v, count_y);
+
+        divide_limbs_by_limb(u, count_y, factor);
+        divide_limbs_by_limb(v, count_y, factor);
+        count_remainder = count_y;
+    }
+
+    if (quotient != NULL) normalize_limb_buffer(quotient, count_quotient, sign_x == sign_y);
+
+    if (remainder != NULL) {
+        count_remainder = normalize_limbs_length(u, count_remainder);
+        bool is_zero = count_remainder == 1 && u[0] == 0;
+
+        if (!is_zero && sign_x != sign_y) {
+            count_remainder = subtract_limbs_modules(u, v, count_y, u, count_remainder);
+        }
+
+        memcpy(remainder->limbs, u, sizeof(Limb) * count_remainder);
+        normalize_limb_buffer(remainder, count_remainder, sign_y);
+    }
+
+    return LIMB_BUFFER_OK;
+}
+
+
+/*
+* @brief Divide dois buffers quando a divisão é sabidamente exata (veja divide_exact_limbs()).
+*
+* @param result Buffer do quociente, com pelo menos quotient_limb_buffers_size() limbs; pode
+*               ser o mesmo que x ou y.
+* @param scratch Área de rascunho com pelo menos divexact_limb_buffers_scratch_size() limbs.
+*
+* @return LIMB_BUFFER_OK, LIMB_BUFFER_TOO_SMALL, LIMB_BUFFER_SCRATCH_TOO_SMALL ou
+*         LIMB_BUFFER_INVALID_INPUT (divisão por zero ou dividendo que não é múltiplo do divisor).
+*/
+
+int divexact_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y, Limb *scratch, int scratch_size) {
+    int count_x = x->count;
+    int count_y = y->count;
+    bool is_positive = x->is_positive == y->is_positive;
+
+    if (count_y == 1 && y->limbs[0] == 0) return LIMB_BUFFER_INVALID_INPUT;
+    if (scratch_size < divexact_limb_buffers_scratch_size(x, y)) return LIMB_BUFFER_SCRATCH_TOO_SMALL;
+    if (quotient_limb_buffers_size(x, y) > result->capacity) return LIMB_BUFFER_TOO_SMALL;
+
+    Limb* a = scratch;
+    Limb* b = scratch + count_x;
+
+    memcpy(a, x->limbs, sizeof(Limb) * count_x);
+    memcpy(b, y->limbs, sizeof(Limb) * count_y);
+
+    int count = divide_exact_limbs(a, count_x, b, count_y);
+
+    if (count < 0) return LIMB_BUFFER_INVALID_INPUT;
+
+    memcpy(result->limbs, a, sizeof(Limb) * count);
+    normalize_limb_buffer(result, count, is_positive);
+
+    return LIMB_BUFFER_OK;
+}
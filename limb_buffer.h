@@ -0,0 +1,45 @@
+#ifndef limb_buffer_h
+#define limb_buffer_h
+
+#include <stdbool.h>
+#include "bignumber.h"
+#include "limbs.h"
+
+#define LIMB_BUFFER_OK 0
+#define LIMB_BUFFER_TOO_SMALL 1
+#define LIMB_BUFFER_SCRATCH_TOO_SMALL 2
+#define LIMB_BUFFER_INVALID_INPUT 3
+
+#define LIMB_KARATSUBA_THRESHOLD 32
+
+typedef struct LimbBuffer {
+    Limb *limbs;
+    int count;
+    int capacity;
+    bool is_positive;
+} LimbBuffer;
+
+void init_limb_buffer(LimbBuffer *buffer, Limb *limbs, int capacity);
+int limb_buffer_from_string(LimbBuffer *result, const char *str_number);
+int limb_buffer_string_size(const LimbBuffer *x);
+int limb_buffer_to_string(const LimbBuffer *x, char *output, int size);
+int limb_buffer_from_big_number(LimbBuffer *result, BigNumber x);
+BigNumber limb_buffer_to_big_number(const LimbBuffer *x);
+
+int limb_buffer_limbs_for_digits(int num_digits);
+int sum_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y);
+int multiply_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y);
+int quotient_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y);
+int remainder_limb_buffers_size(const LimbBuffer *x, const LimbBuffer *y);
+int multiply_limb_buffers_scratch_size(const LimbBuffer *x, const LimbBuffer *y);
+int divide_limb_buffers_scratch_size(const LimbBuffer *x, const LimbBuffer *y);
+int divexact_limb_buffers_scratch_size(const LimbBuffer *x, const LimbBuffer *y);
+
+int sum_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y);
+int subtract_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y);
+int multiply_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y, Limb *scratch, int scratch_size);
+int divide_limb_buffers(LimbBuffer *quotient, LimbBuffer *remainder, const LimbBuffer *x, const LimbBuffer *y,
+                        Limb *scratch, int scratch_size);
+int divexact_limb_buffers(LimbBuffer *result, const LimbBuffer *x, const LimbBuffer *y, Limb *scratch, int scratch_size);
+
+#endif
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "auxiliar.h"
+#include "bignumber.h"
+#include "limbs.h"
+
+
+/*
+* @brief Calcula quantos limbs de base 10^9 são necessários para um número de dígitos.
+*
+* @param num_digits Quantidade de dígitos decimais.
+*
+* @return Quantidade de limbs (no mínimo 1).
+*/
+
+int limbs_length_for_digits(int num_digits) {
+    int length = (num_digits + LIMB_DIGITS - 1) / LIMB_DIGITS;
+
+    return (length > 0) ? length : 1;
+}
+
+
+/*
+* @brief Converte os dígitos de um Big Number para limbs de base 10^9.
+*
+* @param x Big Number a ser convertido.
+* @param limbs Vetor com pelo menos limbs_length_for_digits(x->num_digits) posições.
+*
+* @details Como a base 10^9 é uma potência de 10, a conversão apenas agrupa os dígitos
+*          de 9 em 9, começando pelo último Nó. O limb 0 é o menos significativo.
+*          O sinal não é copiado.
+*
+* @return Quantidade de limbs escritos.
+*/
+
+int big_number_to_limbs(BigNumber x, Limb *limbs) {
+    int count = 0;
+    int position = 0;
+    Limb limb = 0;
+    Limb power = 1;
+
+    for (Node node = x->last_digit; node != NULL; node = node->prev_digit) {
+        limb += node->digit * power;
+        power *= 10;
+        position++;
+
+        if (position == LIMB_DIGITS) {
+            limbs[count++] = limb;
+            limb = 0;
+            power = 1;
+            position = 0;
+        }
+    }
+
+    if (position > 0 || count == 0) limbs[count++] = limb;
+
+    return normalize_limbs_length(limbs, count);
+}
+
+
+/*
+* @brief Cria um Big Number a partir de limbs de base 10^9.
+*
+* @param limbs Vetor de limbs, do menos para o mais significativo.
+* @param count Quantidade de limbs.
+* @param is_positive Sinal do Big Number.
+*
+* @return O Big Number criado.
+*/
+
+BigNumber create_big_number_from_limbs(const Limb *limbs, int count, bool is_positive) {
+    BigNumber big_number = create_big_number("");
+
+    count = normalize_limbs_length(limbs, count);
+
+    for (int i = count - 1; i >= 0; i--) {
+        char digits[LIMB_DIGITS];
+        Limb limb = limbs[i];
+
+        for (int j = LIMB_DIGITS - 1; j >= 0; j--) {
+            digits[j] = limb % 10;
+            limb /= 10;
+        }
+
+        for (int j = 0; j < LIMB_DIGITS; j++) {
+            if (big_number->num_digits == 0 && digits[j] == 0 && !(i == 0 && j == LIMB_DIGITS - 1)) continue;
+
+            add_node_to_big_number(big_number, digits[j], true);
+        }
+    }
+
+    if (big_number->num_digits == 0) add_node_to_big_number(big_number, 0, true);
+
+    big_number->is_positive = (big_number->num_digits == 1 && big_number->first_digit->digit == 0) ? true : is_positive;
+
+    return big_number;
+}
+
+
+/*
+* @brief Ignora os limbs zerados mais significativos.
+*
+* @param limbs Vetor de limbs, do menos para o mais significativo.
+* @param count Quantidade de limbs.
+*
+* @return Quantidade de limbs significativos (no mínimo 1, se count > 0).
+*/
+
+int normalize_limbs_length(const Limb *limbs, int count) {
+    while (count > 1 && limbs[count - 1] == 0) count--;
+
+    return count;
+}
+
+
+/*
+* @brief Calcula o inverso de um limb módulo 10^9.
+*
+* @param x Limb primo com 10 (ímpar e não divisível por 5).
+*
+* @details Usa o algoritmo de Euclides estendido.
+*
+* @return O limb y tal que x * y = 1 (mod 10^9).
+*/
+
+Limb inverse_of_limb(Limb x) {
+    int64_t old_r = LIMB_BASE, r = x;
+    int64_t old_s = 0, s = 1;
+
+    while (r != 0) {
+        int64_t quotient = old_r / r;
+        int64_t swap;
+
+        swap = r; r = old_r - quotient * r; old_r = swap;
+        swap = s; s = old_s - quotient * s; old_s = swap;
+    }
+
+    return ((old_s % (int64_t) LIMB_BASE) + LIMB_BASE) % LIMB_BASE;
+}
+
+
+/*
+* @brief Compara dois vetores de limbs com o mesmo tamanho.
+*
+* @return 1, 0 ou -1, como compare_big_numbers_modules().
+*/
+
+int compare_limbs(const Limb *x, const Limb *y, int count) {
+    for (int i = count - 1; i >= 0; i--) {
+        if (x[i] != y[i]) return (x[i] > y[i]) ? 1 : -1;
+    }
+
+    return 0;
+}
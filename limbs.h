@@ -0,0 +1,19 @@
+#ifndef limbs_h
+#define limbs_h
+
+#include <stdint.h>
+#include "bignumber.h"
+
+#define LIMB_BASE 1000000000u
+#define LIMB_DIGITS 9
+
+typedef uint32_t Limb;
+
+int limbs_length_for_digits(int num_digits);
+int big_number_to_limbs(BigNumber x, Limb *limbs);
+BigNumber create_big_number_from_limbs(const Limb *limbs, int count, bool is_positive);
+int normalize_limbs_length(const Limb *limbs, int count);
+Limb inverse_of_limb(Limb x);
+int compare_limbs(const Limb *x, const Limb *y, int count);
+
+#endif
@@ -0,0 +1,374 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "auxiliar.h"
+#include "bignumber.h"
+#include "ntt.h"
+#include "storage.h"
+#include "thread_pool.h"
+#include "tuning.h"
+
+
+static const uint32_t ntt_primes[NTT_NUM_PRIMES] = {998244353u, 167772161u};
+static const uint32_t ntt_generators[NTT_NUM_PRIMES] = {3u, 3u};
+
+
+typedef struct ButterflyStage {
+    uint32_t *values;
+    const uint32_t *roots;
+    int length;
+    int half;
+    int root_step;
+    uint32_t prime;
+} ButterflyStage;
+
+
+typedef struct NttProduct {
+    const uint32_t *limbs_x;
+    const uint32_t *limbs_y;
+    int length_x;
+    int length_y;
+    int length;
+    uint32_t *residues[NTT_NUM_PRIMES];
+    uint64_t *coefficients;
+} NttProduct;
+
+
+/*
+* @brief Calcula (base ^ exponent) mod prime.
+*/
+
+static uint32_t power_mod(uint32_t base, uint64_t exponent, uint32_t prime) {
+    uint64_t result = 1;
+    uint64_t current = base % prime;
+
+    while (exponent > 0) {
+        if (exponent & 1) result = result * current % prime;
+
+        current = current * current % prime;
+        exponent >>= 1;
+    }
+
+    return result;
+}
+
+
+/*
+* @brief Verifica se o produto de dois números cabe no maior tamanho de transformada suportado.
+*
+* @param num_digits_x Quantidade de dígitos do primeiro operando.
+* @param num_digits_y Quantidade de dígitos do segundo operando.
+*
+* @return true, se a multiplicação pode ser feita pela NTT.
+*/
+
+bool fits_in_ntt(int num_digits_x, int num_digits_y) {
+    long long limbs = (long long) num_digits_x / NTT_BASE_DIGITS + num_digits_y / NTT_BASE_DIGITS + 2;
+
+    return limbs <= NTT_MAX_LENGTH;
+}
+
+
+/*
+* @brief Executa um bloco de borboletas de um estágio da transformada.
+*
+* @param context Estágio da transformada (ButterflyStage).
+* @param index Índice do bloco de NTT_PARALLEL_CHUNK borboletas.
+*
+* @details As length / 2 borboletas de um estágio são independentes entre si, então
+*          cada bloco pode ser executado em uma thread diferente.
+*/
+
+static void run_butterflies(void *context, int index) {
+    ButterflyStage* stage = context;
+
+    int begin = index * NTT_PARALLEL_CHUNK;
+    int end = begin + NTT_PARALLEL_CHUNK;
+
+    if (end > stage->length / 2) end = stage->length / 2;
+
+    for (int k = begin; k < end; k++) {
+        int j = k % stage->half;
+        int i = (k / stage->half) * 2 * stage->half + j;
+
+        uint32_t u = stage->values[i];
+        uint32_t v = (uint64_t) stage->values[i + stage->half] * stage->roots[j * stage->root_step] % stage->prime;
+
+        stage->values[i] = (u + v >= stage->prime) ? u + v - stage->prime : u + v;
+        stage->values[i + stage->half] = (u >= v) ? u - v : u + stage->prime - v;
+    }
+}
+
+
+/*
+* @brief Calcula a transformada numérica (NTT) de um vetor, no próprio vetor.
+*
+* @param values Vetor com "length" valores menores que o primo.
+* @param length Tamanho do vetor (potência de 2, até NTT_MAX_LENGTH).
+* @param invert Se verdadeiro, calcula a transformada inversa.
+* @param prime_index Índice do primo em ntt_primes.
+*
+* @details Implementação iterativa de Cooley-Tukey. Quando length é pelo menos
+*          bignumber_thresholds.parallel, as borboletas de cada estágio são divididas entre as
+*          threads do pool.
+*/
+
+static void number_theoretic_transform(uint32_t *values, int length, bool invert, int prime_index) {
+    uint32_t prime = ntt_primes[prime_index];
+
+    for (int i = 1, j = 0; i < length; i++) {
+        int bit = length >> 1;
+
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+
+        if (i < j) {
+            uint32_t swap = values[i];
+            values[i] = values[j];
+            values[j] = swap;
+        }
+    }
+
+    size_t roots_size = sizeof(uint32_t) * (length / 2 + 1);
+    uint32_t* roots = allocate_storage_array(roots_size, false);
+    uint32_t root = power_mod(ntt_generators[prime_index], (prime - 1) / length, prime);
+
+    if (invert) root = power_mod(root, prime - 2, prime);
+
+    roots[0] = 1;
+    for (int i = 1; i < length / 2; i++) roots[i] = (uint64_t) roots[i - 1] * root % prime;
+
+    for (int half = 1; half < length; half *= 2) {
+        ButterflyStage stage = {values, roots, length, half, length / (2 * half), prime};
+        int chunks = (length / 2 + NTT_PARALLEL_CHUNK - 1) / NTT_PARALLEL_CHUNK;
+
+        if (length >= bignumber_thresholds.parallel) {
+            bignumber_parallel_for(run_butterflies, &stage, chunks);
+        }
+
+        else {
+            for (int i = 0; i < chunks; i++) run_butterflies(&stage, i);
+        }
+    }
+
+    if (invert) {
+        uint32_t inverse_length = power_mod(length, prime - 2, prime);
+
+        for (int i = 0; i < length; i++) values[i] = (uint64_t) values[i] * inverse_length % prime;
+    }
+
+    release_storage_array(roots, roots_size);
+}
+
+
+/*
+* @brief Calcula a convolução dos dois operandos módulo um dos primos.
+*
+* @param context Dados da multiplicação (NttProduct).
+* @param prime_index Índice do primo em ntt_primes.
+*
+* @details Cada primo é independente dos outros, então eles são calculados em threads diferentes.
+*/
+
+static void convolve_modulo_prime(void *context, int prime_index) {
+    NttProduct* product = context;
+    uint32_t prime = ntt_primes[prime_index];
+    bool is_square = product->limbs_x == product->limbs_y;
+
+    size_t transform_size = sizeof(uint32_t) * product->length;
+
+    uint32_t* transformed_x = allocate_storage_array(transform_size, false);
+    uint32_t* transformed_y = is_square ? transformed_x : allocate_storage_array(transform_size, false);
+
+    for (int i = 0; i < product->length_x; i++) transformed_x[i] = product->limbs_x[i] % prime;
+    number_theoretic_transform(transformed_x, product->length, false, prime_index);
+
+    if (!is_square) {
+        for (int i = 0; i < product->length_y; i++) transformed_y[i] = product->limbs_y[i] % prime;
+        number_theoretic_transform(transformed_y, product->length, false, prime_index);
+    }
+
+    for (int i = 0; i < product->length; i++) {
+        transformed_x[i] = (uint64_t) transformed_x[i] * transformed_y[i] % prime;
+    }
+
+    number_theoretic_transform(transformed_x, product->length, true, prime_index);
+
+    if (!is_square) release_storage_array(transformed_y, transform_size);
+
+    product->residues[prime_index] = transformed_x;
+}
+
+
+/*
+* @brief Reconstrói um bloco de coeficientes da convolução pelo Teorema Chinês do Resto.
+*
+* @param context Dados da multiplicação (NttProduct).
+* @param index Índice do bloco de NTT_PARALLEL_CHUNK coeficientes.
+*
+* @details Cada coeficiente é menor que o produto dos dois primos, então cabe em 64 bits.
+*/
+
+static void reconstruct_coefficients(void *context, int index) {
+    NttProduct* product = context;
+    const uint32_t p1 = ntt_primes[0];
+    const uint32_t p2 = ntt_primes[1];
+    const uint64_t p1_inverse = power_mod(p1, p2 - 2, p2);
+
+    int begin = index * NTT_PARALLEL_CHUNK;
+    int end = begin + NTT_PARALLEL_CHUNK;
+
+    if (end > product->length) end = product->length;
+
+    for (int i = begin; i < end; i++) {
+        uint64_t r1 = product->residues[0][i];
+        uint64_t r2 = product->residues[1][i];
+        uint64_t difference = (r2 + p2 - r1 % p2) % p2;
+
+        product->coefficients[i] = r1 + (uint64_t) p1 * (difference * p1_inverse % p2);
+    }
+}
+
+
+/*
+* @brief Converte os dígitos de um Big Number para limbs de base NTT_BASE.
+*
+* @param x Big Number a ser convertido.
+* @param limbs Vetor de destino, do menos para o mais significativo.
+*
+* @return Quantidade de limbs escritos.
+*/
+
+int big_number_to_ntt_limbs(BigNumber x, uint32_t *limbs) {
+    int count = 0;
+    int position = 0;
+    uint32_t power = 1;
+
+    limbs[0] = 0;
+
+    for (Node node = x->last_digit; node != NULL; node = node->prev_digit) {
+        limbs[count] += node->digit * power;
+        power *= 10;
+
+        if (++position == NTT_BASE_DIGITS) {
+            limbs[++count] = 0;
+            power = 1;
+            position = 0;
+        }
+    }
+
+    return count + 1;
+}
+
+
+/*
+* @brief Calcula a convolução de dois vetores de limbs pela transformada numérica (NTT).
+*
+* @param limbs_x Limbs do primeiro operando, do menos para o mais significativo.
+* @param length_x Quantidade de limbs do primeiro operando.
+* @param limbs_y Limbs do segundo operando (pode ser o mesmo vetor de limbs_x).
+* @param length_y Quantidade de limbs do segundo operando.
+* @param length Recebe o tamanho da transformada (quantidade de coeficientes).
+*
+* @details A convolução é calculada módulo dois primos e os coeficientes são reconstruídos
+*          pelo Teorema Chinês do Resto. Quando a transformada tem pelo menos
+*          bignumber_thresholds.parallel limbs, cada primo fica em uma thread, a reconstrução é dividida
+*          entre as threads do pool e as borboletas de cada estágio também; abaixo disso,
+*          tudo roda na thread atual, sem passar pelo pool. Cada coeficiente deve ser menor
+*          que o produto dos primos, o que vale para limbs menores que 2^16 e transformadas
+*          de até NTT_MAX_LENGTH limbs.
+*
+* @return Vetor com os coeficientes, sem propagação do transporte, alocado por
+*         allocate_storage_array() (liberar com release_storage_array()).
+*/
+
+uint64_t* convolve_ntt_limbs(const uint32_t *limbs_x, int length_x, const uint32_t *limbs_y, int length_y, int *length) {
+    NttProduct product;
+
+    product.limbs_x = limbs_x;
+    product.limbs_y = limbs_y;
+    product.length_x = length_x;
+    product.length_y = length_y;
+    product.length = 1;
+
+    while (product.length < product.length_x + product.length_y) product.length *= 2;
+
+    bool is_parallel = product.length >= bignumber_thresholds.parallel;
+    int chunks = (product.length + NTT_PARALLEL_CHUNK - 1) / NTT_PARALLEL_CHUNK;
+
+    if (is_parallel) {
+        bignumber_parallel_for(convolve_modulo_prime, &product, NTT_NUM_PRIMES);
+    }
+
+    else {
+        for (int i = 0; i < NTT_NUM_PRIMES; i++) convolve_modulo_prime(&product, i);
+    }
+
+    product.coefficients = allocate_storage_array(sizeof(uint64_t) * product.length, true);
+
+    if (is_parallel) {
+        bignumber_parallel_for(reconstruct_coefficients, &product, chunks);
+    }
+
+    else {
+        for (int i = 0; i < chunks; i++) reconstruct_coefficients(&product, i);
+    }
+
+    for (int i = 0; i < NTT_NUM_PRIMES; i++) release_storage_array(product.residues[i], sizeof(uint32_t) * product.length);
+
+    *length = product.length;
+
+    return product.coefficients;
+}
+
+
+/*
+* @brief Multiplica dois Big Numbers pela transformada numérica (NTT).
+*
+* @param x Big Number a ser multiplicado.
+* @param y Big Number a ser multiplicado.
+*
+* @details Os números são agrupados em limbs de 4 dígitos, a convolução é calculada por
+*          convolve_ntt_limbs() e o transporte é propagado uma única vez. O produto deve
+*          caber em NTT_MAX_LENGTH limbs (veja fits_in_ntt()).
+*
+* @return Big Number resultado da multiplicação.
+*/
+
+BigNumber multiply_ntt_big_numbers(BigNumber x, BigNumber y) {
+    size_t limbs_size_x = sizeof(uint32_t) * (x->num_digits / NTT_BASE_DIGITS + 2);
+    size_t limbs_size_y = sizeof(uint32_t) * (y->num_digits / NTT_BASE_DIGITS + 2);
+
+    uint32_t* limbs_x = allocate_storage_array(limbs_size_x, true);
+    uint32_t* limbs_y = (x == y) ? limbs_x : allocate_storage_array(limbs_size_y, true);
+
+    int length_x = big_number_to_ntt_limbs(x, limbs_x);
+    int length_y = (x == y) ? length_x : big_number_to_ntt_limbs(y, limbs_y);
+    int length;
+
+    uint64_t* coefficients = convolve_ntt_limbs(limbs_x, length_x, limbs_y, length_y, &length);
+
+    BigNumber result = create_big_number("");
+    uint64_t carry = 0;
+
+    for (int i = 0; i < length; i++) {
+        uint64_t value = coefficients[i] + carry;
+        uint32_t limb = value % NTT_BASE;
+
+        carry = value / NTT_BASE;
+
+        for (int j = 0; j < NTT_BASE_DIGITS; j++) {
+            add_node_to_big_number(result, limb % 10, false);
+            limb /= 10;
+        }
+    }
+
+    result->is_even = (result->last_digit->digit % 2 == 0) ? true : false;
+    remove_zeros_from_left(result);
+    result->is_positive = (x->is_positive == y->is_positive) || (result->num_digits == 1 && result->first_digit->digit == 0);
+
+    release_storage_array(coefficients, sizeof(uint64_t) * length);
+    release_storage_array(limbs_x, limbs_size_x);
+    if (x != y) release_storage_array(limbs_y, limbs_size_y);
+
+    return result;
+}
@@ -0,0 +1,18 @@
+#ifndef ntt_h
+#define ntt_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bignumber.h"
+
+#define NTT_BASE 10000
+#define NTT_BASE_DIGITS 4
+#define NTT_MAX_LENGTH (1 << 23)
+#define NTT_NUM_PRIMES 2
+#define NTT_PARALLEL_CHUNK 8192
+
+bool fits_in_ntt(int num_digits_x, int num_digits_y);
+int big_number_to_ntt_limbs(BigNumber x, uint32_t *limbs);
+uint64_t* convolve_ntt_limbs(const uint32_t *limbs_x, int length_x, const uint32_t *limbs_y, int length_y, int *length);
+
+#endif
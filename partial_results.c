@@ -0,0 +1,492 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "auxiliar.h"
+#include "bignumber.h"
+#include "budget.h"
+
+#define PARTIAL_GUARD_DIGITS 20
+#define PARTIAL_MAX_RESULT_DIGITS 1e18
+
+
+/*
+* Número truncado: o valor representado é mantissa * 10^shift. Cada cota (inferior ou
+* superior) de um resultado é mantida como um número truncado com uma precisão fixa
+* de dígitos na mantissa.
+*/
+
+typedef struct TruncatedNumber {
+    BigNumber mantissa;
+    long long shift;
+} TruncatedNumber;
+
+
+/*
+* @brief Trunca a mantissa de um número truncado para no máximo "precision" dígitos.
+*
+* @param x Número truncado, alterado no lugar.
+* @param precision Quantidade de dígitos mantidos.
+* @param round_up Se verdadeiro, arredonda para cima quando algum dígito descartado não é zero
+*                 (cota superior); se falso, apenas descarta (cota inferior).
+*/
+
+static void truncate_mantissa(TruncatedNumber *x, int precision, bool round_up) {
+    int dropped_digits = x->mantissa->num_digits - precision;
+
+    if (dropped_digits <= 0) return;
+
+    bool has_nonzero_dropped = false;
+    Node node = x->mantissa->last_digit;
+
+    for (int i = 0; i < dropped_digits && !has_nonzero_dropped; i++) {
+        has_nonzero_dropped = node->digit != 0;
+        node = node->prev_digit;
+    }
+
+    BigNumber truncated = divide_by_power_of_ten(x->mantissa, dropped_digits);
+
+    if (round_up && has_nonzero_dropped) {
+        BigNumber one = create_big_number("1");
+        BigNumber rounded = sum_big_numbers(truncated, one);
+
+        free_big_number(one);
+        free_big_number(truncated);
+        truncated = rounded;
+    }
+
+    free_big_number(x->mantissa);
+    x->mantissa = truncated;
+    x->shift += dropped_digits;
+}
+
+
+/*
+* @brief Multiplica dois números truncados, truncando o produto na mesma precisão.
+*
+* @return Novo número truncado com o produto (os operandos não são liberados).
+*/
+
+static TruncatedNumber multiply_truncated(TruncatedNumber x, TruncatedNumber y, int precision, bool round_up) {
+    TruncatedNumber result;
+
+    result.mantissa = multiply_karatsuba_big_numbers(x.mantissa, y.mantissa);
+    result.shift = x.shift + y.shift;
+
+    truncate_mantissa(&result, precision, round_up);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula uma cota de |base|^exponent com a mantissa limitada a "precision" dígitos.
+*
+* @details Exponenciação binária da esquerda para a direita, truncando depois de cada
+*          multiplicação sempre no mesmo sentido, então o resultado é uma cota inferior
+*          (round_up falso) ou superior (round_up verdadeiro) da potência exata.
+*/
+
+static TruncatedNumber power_truncated(BigNumber base, long long exponent, int precision, bool round_up) {
+    TruncatedNumber x = {duplicate_big_number(base), 0};
+    TruncatedNumber result = {create_big_number("1"), 0};
+
+    x.mantissa->is_positive = true;
+    truncate_mantissa(&x, precision, round_up);
+
+    int bit = 62;
+
+    while (bit >= 0 && !((exponent >> bit) & 1)) bit--;
+
+    for (; bit >= 0 && !is_request_cancelled(); bit--) {
+        TruncatedNumber squared = multiply_truncated(result, result, precision, round_up);
+
+        free_big_number(result.mantissa);
+        result = squared;
+
+        if ((exponent >> bit) & 1) {
+            TruncatedNumber product = multiply_truncated(result, x, precision, round_up);
+
+            free_big_number(result.mantissa);
+            result = product;
+        }
+    }
+
+    free_big_number(x.mantissa);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula as cotas inferior e superior do valor absoluto de x * y ou x ^ y.
+*
+* @return true se a operação é atendida, false caso contrário (operação desconhecida,
+*         expoente negativo ou que não cabe em long long, ou resultado grande demais).
+*/
+
+static bool compute_truncated_bounds(char operation, BigNumber x, BigNumber y, int precision,
+                              TruncatedNumber *lower, TruncatedNumber *upper) {
+    if (operation == '*') {
+        for (int i = 0; i < 2; i++) {
+            bool round_up = i == 1;
+            TruncatedNumber a = {duplicate_big_number(x), 0};
+            TruncatedNumber b = {duplicate_big_number(y), 0};
+
+            a.mantissa->is_positive = true;
+            b.mantissa->is_positive = true;
+            truncate_mantissa(&a, precision, round_up);
+            truncate_mantissa(&b, precision, round_up);
+
+            *(round_up ? upper : lower) = multiply_truncated(a, b, precision, round_up);
+
+            free_big_number(a.mantissa);
+            free_big_number(b.mantissa);
+        }
+
+        return true;
+    }
+
+    long long exponent;
+
+    if (operation != '^' || !big_number_to_long(y, &exponent) || exponent < 0) return false;
+    if (exponent * fmax(estimate_log10(x) + 1, 1) > PARTIAL_MAX_RESULT_DIGITS) return false;
+
+    *lower = power_truncated(x, exponent, precision, false);
+    *upper = power_truncated(x, exponent, precision, true);
+
+    return true;
+}
+
+
+/*
+* @brief Verifica se as duas cotas têm a mesma quantidade de dígitos e os mesmos k primeiros dígitos.
+*
+* @param num_digits Ponteiro onde a quantidade de dígitos é armazenada, se as cotas concordarem.
+*/
+
+static bool truncated_bounds_agree(TruncatedNumber lower, TruncatedNumber upper, int k, long long *num_digits) {
+    long long digits_lower = lower.mantissa->num_digits + lower.shift;
+    long long digits_upper = upper.mantissa->num_digits + upper.shift;
+
+    if (digits_lower != digits_upper) return false;
+
+    Node node_lower = lower.mantissa->first_digit;
+    Node node_upper = upper.mantissa->first_digit;
+
+    for (int i = 0; i < k && i < digits_lower; i++) {
+        int digit_lower = (node_lower != NULL) ? node_lower->digit : 0;
+        int digit_upper = (node_upper != NULL) ? node_upper->digit : 0;
+
+        if (digit_lower != digit_upper) return false;
+
+        if (node_lower != NULL) node_lower = node_lower->next_digit;
+        if (node_upper != NULL) node_upper = node_upper->next_digit;
+    }
+
+    *num_digits = digits_lower;
+
+    return true;
+}
+
+
+/*
+* @brief Calcula a quantidade de dígitos e os primeiros dígitos do resultado, sem calculá-lo inteiro.
+*
+* @param operation '*' ou '^'.
+* @param x Primeiro operando (base, para '^').
+* @param y Segundo operando (expoente, para '^').
+* @param k Quantidade de dígitos iniciais pedidos (0 para apenas contar os dígitos).
+* @param num_digits Ponteiro onde a quantidade de dígitos é armazenada.
+* @param leading Ponteiro onde os primeiros dígitos são armazenados (pode ser NULL).
+*
+* @details O valor exato fica entre duas cotas calculadas com mantissas de precisão fixa,
+*          uma truncada para baixo e outra para cima. Se as cotas tiverem a mesma quantidade
+*          de dígitos e os mesmos k primeiros dígitos, eles são os do valor exato; se não,
+*          a precisão é dobrada e as cotas são recalculadas. Quando a precisão passa do
+*          tamanho do resultado, nada é truncado e as cotas coincidem, então o laço sempre termina.
+*
+* @return true em caso de sucesso, false se a operação não for atendida.
+*/
+
+static bool find_leading_digits(char operation, BigNumber x, BigNumber y, int k, long long *num_digits, BigNumber *leading) {
+    int precision = k + PARTIAL_GUARD_DIGITS;
+    *num_digits = 1;
+
+    while (1) {
+        TruncatedNumber lower, upper;
+
+        if (!compute_truncated_bounds(operation, x, y, precision, &lower, &upper)) return false;
+
+        bool has_converged = truncated_bounds_agree(lower, upper, k, num_digits) || is_request_cancelled();
+
+        if (has_converged && leading != NULL) {
+            int length = (*num_digits < k) ? *num_digits : k;
+
+            *leading = create_big_number("");
+
+            Node node = lower.mantissa->first_digit;
+
+            for (int i = 0; i < length; i++) {
+                add_node_to_big_number(*leading, (node != NULL) ? node->digit : 0, true);
+                if (node != NULL) node = node->next_digit;
+            }
+        }
+
+        free_big_number(lower.mantissa);
+        free_big_number(upper.mantissa);
+
+        if (has_converged) return true;
+
+        precision *= 2;
+    }
+}
+
+
+/*
+* @brief Indica se o resultado de x * y ou x ^ y é negativo.
+*/
+
+static bool is_result_negative(char operation, BigNumber x, BigNumber y) {
+    if (operation == '*') return x->is_positive != y->is_positive;
+
+    return !x->is_positive && !y->is_even;
+}
+
+
+/*
+* @brief Calcula a quantidade de dígitos do resultado de x * y ou x ^ y, sem calculá-lo.
+*
+* @param operation '*' ou '^'.
+* @param x Primeiro operando (base, para '^').
+* @param y Segundo operando (expoente, para '^').
+*
+* @return Quantidade de dígitos, ou -1 se a operação não for atendida.
+*/
+
+long long count_digits_of_result(char operation, BigNumber x, BigNumber y) {
+    long long num_digits;
+
+    if (!find_leading_digits(operation, x, y, 0, &num_digits, NULL)) return -1;
+
+    return num_digits;
+}
+
+
+/*
+* @brief Calcula os k primeiros dígitos do resultado de x * y ou x ^ y, sem calculá-lo.
+*
+* @param operation '*' ou '^'.
+* @param x Primeiro operando (base, para '^').
+* @param y Segundo operando (expoente, para '^').
+* @param k Quantidade de dígitos pedidos.
+*
+* @details Se o resultado tiver menos de k dígitos, ele é devolvido inteiro. O sinal é o
+*          do resultado.
+*
+* @return Big Number com os primeiros dígitos, ou NULL se a operação não for atendida.
+*/
+
+BigNumber leading_digits_of_result(char operation, BigNumber x, BigNumber y, int k) {
+    long long num_digits;
+    BigNumber leading;
+
+    if (k <= 0 || !find_leading_digits(operation, x, y, k, &num_digits, &leading)) return NULL;
+
+    leading->is_positive = !is_result_negative(operation, x, y) ||
+                           (leading->first_digit == leading->last_digit && leading->first_digit->digit == 0);
+
+    return leading;
+}
+
+
+/*
+* @brief Multiplica dois Big Numbers módulo 10^k.
+*
+* @return Novo Big Number, sem zeros à esquerda.
+*/
+
+static BigNumber multiply_modulo_power_of_ten(BigNumber x, BigNumber y, int k) {
+    BigNumber product = multiply_karatsuba_big_numbers(x, y);
+    BigNumber result = get_remainder_by_power_of_ten(product, k);
+
+    remove_zeros_from_left(result);
+    free_big_number(product);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula |base|^exponent módulo 10^k.
+*
+* @details Percorre os dígitos decimais do expoente da esquerda para a direita: a cada
+*          dígito d, o resultado é elevado a 10 (três quadrados e um produto) e multiplicado
+*          por base^d, tirado de uma tabela com as potências de 0 a 9. Todas as
+*          multiplicações têm operandos de até k dígitos, e o expoente pode ter qualquer tamanho.
+*/
+
+static BigNumber power_modulo_power_of_ten(BigNumber base, BigNumber exponent, int k) {
+    BigNumber powers[10];
+
+    BigNumber absolute_base = get_remainder_by_power_of_ten(base, k);
+    absolute_base->is_positive = true;
+    remove_zeros_from_left(absolute_base);
+
+    powers[0] = create_big_number("1");
+
+    for (int d = 1; d < 10; d++) powers[d] = multiply_modulo_power_of_ten(powers[d - 1], absolute_base, k);
+
+    BigNumber result = create_big_number("1");
+
+    for (Node node = exponent->first_digit; node != NULL && !is_request_cancelled(); node = node->next_digit) {
+        BigNumber squared = multiply_modulo_power_of_ten(result, result, k);
+        BigNumber fourth = multiply_modulo_power_of_ten(squared, squared, k);
+        BigNumber fifth = multiply_modulo_power_of_ten(fourth, result, k);
+        BigNumber tenth = multiply_modulo_power_of_ten(fifth, fifth, k);
+
+        free_big_number(result);
+        result = multiply_modulo_power_of_ten(tenth, powers[(int) node->digit], k);
+
+        free_big_number(squared);
+        free_big_number(fourth);
+        free_big_number(fifth);
+        free_big_number(tenth);
+    }
+
+    for (int d = 0; d < 10; d++) free_big_number(powers[d]);
+    free_big_number(absolute_base);
+
+    return result;
+}
+
+
+/*
+* @brief Calcula os k últimos dígitos do resultado de x * y ou x ^ y, sem calculá-lo.
+*
+* @param operation '*' ou '^'.
+* @param x Primeiro operando (base, para '^').
+* @param y Segundo operando (expoente, para '^').
+* @param k Quantidade de dígitos pedidos.
+*
+* @details Usa aritmética módulo 10^k. Quando o resultado certamente tem pelo menos k
+*          dígitos, os zeros à esquerda dos k dígitos são mantidos; quando pode ter menos,
+*          ele é pequeno e é calculado inteiro. O sinal é o do resultado.
+*
+* @return Big Number com os últimos dígitos, ou NULL se a operação não for atendida.
+*/
+
+BigNumber trailing_digits_of_result(char operation, BigNumber x, BigNumber y, int k) {
+    BigNumber result;
+    double min_result_digits;
+
+    if (k <= 0 || (operation != '*' && operation != '^') || (operation == '^' && !y->is_positive)) return NULL;
+
+    if (operation == '*') {
+        BigNumber truncated_x = get_remainder_by_power_of_ten(x, k);
+        BigNumber truncated_y = get_remainder_by_power_of_ten(y, k);
+
+        truncated_x->is_positive = true;
+        truncated_y->is_positive = true;
+        remove_zeros_from_left(truncated_x);
+        remove_zeros_from_left(truncated_y);
+
+        result = multiply_modulo_power_of_ten(truncated_x, truncated_y, k);
+        min_result_digits = x->num_digits + y->num_digits - 1;
+
+        free_big_number(truncated_x);
+        free_big_number(truncated_y);
+    }
+
+    else {
+        bool is_exponent_zero = y->num_digits == 1 && y->first_digit->digit == 0;
+
+        result = power_modulo_power_of_ten(x, y, k);
+        min_result_digits = is_exponent_zero ? 0 : floor(estimate_result_digits('^', x, y)) - 1;
+    }
+
+    bool is_x_zero = x->num_digits == 1 && x->first_digit->digit == 0;
+    bool is_y_zero = y->num_digits == 1 && y->first_digit->digit == 0;
+    bool is_zero = (operation == '*') ? (is_x_zero || is_y_zero) : (is_x_zero && !is_y_zero);
+
+    if (min_result_digits >= k && !is_zero) {
+        while (result->num_digits < k) add_node_to_big_number(result, 0, false);
+    }
+
+    else if (!is_zero) {
+        bool sign_x = x->is_positive;
+        bool sign_y = y->is_positive;
+        BigNumber full_result = (operation == '*') ? multiply_karatsuba_big_numbers(x, y) : fast_exponentiation(x, y);
+
+        x->is_positive = sign_x;
+        y->is_positive = sign_y;
+
+        free_big_number(result);
+        result = get_remainder_by_power_of_ten(full_result, k);
+
+        if (full_result->num_digits > k) {
+            free_big_number(full_result);
+        }
+
+        else {
+            free_big_number(result);
+            result = full_result;
+        }
+    }
+
+    result->is_positive = !is_result_negative(operation, x, y) || is_zero;
+
+    return result;
+}
+
+
+/*
+* @brief Verifica se um comando de resultado parcial cabe nos limites de uma requisição.
+*
+* @param operation '*' ou '^'.
+* @param x Primeiro operando (base, para '^').
+* @param y Segundo operando (expoente, para '^').
+* @param k Quantidade de dígitos pedidos (0 para "digits").
+* @param is_trailing Se verdadeiro, o comando é "trailing"; se não, "digits" ou "leading".
+*
+* @details Os números intermediários têm p dígitos, onde p é k + PARTIAL_GUARD_DIGITS (cotas
+*          dos primeiros dígitos) ou k (aritmética módulo 10^k), mas nunca mais que o
+*          resultado inteiro. As cotas fazem 2 multiplicações para '*' e 4 por bit do
+*          expoente para '^'; a potência módulo 10^k faz 5 por dígito decimal do expoente,
+*          mais a tabela de 9 potências, que fica inteira na memória. Quando os últimos
+*          dígitos precisam do resultado inteiro (veja trailing_digits_of_result()), o custo
+*          da operação completa é somado.
+*
+* @return Mensagem de erro, ou NULL se o comando pode ser executado.
+*/
+
+const char* check_partial_result_budget(char operation, BigNumber x, BigNumber y, int k, bool is_trailing) {
+    double result_digits = estimate_result_digits(operation, x, y);
+    double precision = fmin(is_trailing ? k : k + PARTIAL_GUARD_DIGITS, result_digits);
+    double multiplication = estimate_multiplication_cost(precision, precision);
+    double multiplications, stored_numbers;
+
+    if (operation == '*') {
+        multiplications = is_trailing ? 1 : 2;
+        stored_numbers = 4;
+    }
+
+    else if (is_trailing) {
+        multiplications = 5 * y->num_digits + 9;
+        stored_numbers = 16;
+    }
+
+    else {
+        multiplications = 4 * (fmax(estimate_log10(y), 0) * log2(10) + 1);
+        stored_numbers = 6;
+    }
+
+    double memory = stored_numbers * 2 * precision * sizeof(struct Node) * MEMORY_OVERHEAD_FACTOR;
+    double cost = multiplications * multiplication + x->num_digits + y->num_digits;
+
+    if (is_trailing && result_digits <= k + 1) {
+        memory += result_digits * sizeof(struct Node) * MEMORY_OVERHEAD_FACTOR;
+        cost += estimate_operation_cost(operation, x, y);
+    }
+
+    return check_budget_limits(memory, cost);
+}
@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "auxiliar.h"
+#include "server.h"
+
+
+static pthread_mutex_t active_clients_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int active_clients = 0;
+
+
+/*
+* @brief Atende um cliente conectado ao servidor.
+*
+* @param argument Ponteiro alocado dinamicamente com o descritor do socket do cliente.
+*
+* @details Cada cliente é atendido em sua própria thread, com o mesmo protocolo de
+*          execute_program(). O socket recebe um tempo máximo de inatividade, e cada
+*          linha é limitada a SERVER_MAX_LINE_LENGTH bytes. As respostas são enviadas
+*          ao final de cada requisição.
+*
+* @return NULL.
+*/
+
+void* serve_client(void *argument) {
+    int client_fd = *(int*) argument;
+    free(argument);
+
+    struct timeval timeout = {SERVER_IDLE_TIMEOUT_SECONDS, 0};
+    setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    int output_fd = dup(client_fd);
+    FILE* input = fdopen(client_fd, "r");
+    FILE* output = (output_fd >= 0) ? fdopen(output_fd, "w") : NULL;
+
+    if (input != NULL && output != NULL) {
+        Connection connection = create_connection(input, output, SERVER_MAX_LINE_LENGTH, true);
+
+        execute_connection(connection);
+        fflush(output);
+
+        free(connection);
+    }
+
+    if (input != NULL) fclose(input);
+    else close(client_fd);
+
+    if (output != NULL) fclose(output);
+    else if (output_fd >= 0) close(output_fd);
+
+    pthread_mutex_lock(&active_clients_mutex);
+    active_clients--;
+    pthread_mutex_unlock(&active_clients_mutex);
+
+    return NULL;
+}
+
+
+/*
+* @brief Executa o programa como um servidor persistente em um socket Unix.
+*
+* @param socket_path Caminho do socket a ser criado (um arquivo antigo é removido).
+*
+* @details O processo permanece ativo entre as requisições, então todo estado já
+*          aquecido (como a memória reaproveitada pelo alocador) é
+*          mantido. Cada cliente é atendido em uma thread própria, e no máximo
+*          SERVER_MAX_CLIENTS clientes são atendidos ao mesmo tempo; os excedentes
+*          recebem uma mensagem de erro e são desconectados.
+*
+* @return int 1 em caso de erro ao criar o socket; caso contrário, a função não retorna.
+*/
+
+int run_server(const char *socket_path) {
+    struct sockaddr_un address;
+
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Caminho do socket longo demais\n");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socket_path);
+
+    unlink(socket_path);
+
+    if (server_fd < 0 || bind(server_fd, (struct sockaddr*) &address, sizeof(address)) < 0 ||
+        listen(server_fd, SERVER_MAX_CLIENTS) < 0) {
+        perror("Erro ao iniciar o servidor");
+        if (server_fd >= 0) close(server_fd);
+        return 1;
+    }
+
+    while (1) {
+        int client_fd = accept(server_fd, NULL, NULL);
+
+        if (client_fd < 0) continue;
+
+        pthread_mutex_lock(&active_clients_mutex);
+        bool is_accepted = active_clients < SERVER_MAX_CLIENTS;
+        if (is_accepted) active_clients++;
+        pthread_mutex_unlock(&active_clients_mutex);
+
+        if (!is_accepted) {
+            const char message[] = "Servidor ocupado\n";
+
+            if (write(client_fd, message, sizeof(message) - 1) < 0) perror("Erro ao recusar cliente");
+            close(client_fd);
+            continue;
+        }
+
+        int* argument = malloc(sizeof(int));
+        *argument = client_fd;
+
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, serve_client, argument) != 0) {
+            free(argument);
+            close(client_fd);
+
+            pthread_mutex_lock(&active_clients_mutex);
+            active_clients--;
+            pthread_mutex_unlock(&active_clients_mutex);
+            continue;
+        }
+
+        pthread_detach(thread);
+    }
+
+    return 0;
+}
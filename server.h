@@ -0,0 +1,10 @@
+#ifndef server_h
+#define server_h
+
+#define SERVER_MAX_CLIENTS 64
+#define SERVER_MAX_LINE_LENGTH (64 * 1024 * 1024)
+#define SERVER_IDLE_TIMEOUT_SECONDS 30
+
+int run_server(const char *socket_path);
+
+#endif
@@ -0,0 +1,394 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "bignumber.h"
+#include "storage.h"
+
+
+static pthread_mutex_t storage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool file_storage_enabled = false;
+static int storage_fd = -1;
+static char *storage_directory = NULL;
+
+static char **storage_chunks = NULL;
+static int num_storage_chunks = 0;
+static size_t current_chunk_used = STORAGE_CHUNK_SIZE;
+static Node free_nodes = NULL;
+static long long nodes_in_use = 0;
+
+static __thread Node cached_nodes = NULL;
+static __thread Node last_cached_node = NULL;
+static __thread int num_cached_nodes = 0;
+
+static bool enable_file_storage(const char *directory);
+
+
+/*
+* @brief Inicializa o armazenamento dos Nós a partir do ambiente.
+*
+* @details Se a variável BIGNUMBER_STORAGE_DIR estiver definida, os Nós passam a ser
+*          guardados em um arquivo temporário mapeado na memória nesse diretório.
+*
+* @return true, se o armazenamento padrão ou em arquivo foi configurado com sucesso.
+*/
+
+bool initialize_storage() {
+    const char* directory = getenv("BIGNUMBER_STORAGE_DIR");
+
+    if (directory == NULL || *directory == '\0') return true;
+
+    return enable_file_storage(directory);
+}
+
+
+/*
+* @brief Cria um arquivo temporário em um diretório e o remove do diretório.
+*
+* @param directory Diretório onde o arquivo será criado.
+*
+* @details Como o arquivo não tem mais nome, o espaço é devolvido automaticamente quando
+*          o descritor é fechado e o último mapeamento é desfeito (ou o processo termina).
+*
+* @return Descritor do arquivo, ou -1 em caso de erro.
+*/
+
+static int create_storage_file(const char *directory) {
+    char* path = malloc(strlen(directory) + 32);
+
+    sprintf(path, "%s/bignumber-XXXXXX", directory);
+
+    int fd = mkstemp(path);
+
+    if (fd >= 0) unlink(path);
+    free(path);
+
+    return fd;
+}
+
+
+/*
+* @brief Passa a guardar os Nós em um arquivo temporário mapeado na memória.
+*
+* @param directory Diretório onde o arquivo temporário será criado.
+*
+* @details O arquivo é removido do diretório logo após ser criado, então o espaço é
+*          devolvido automaticamente quando o processo termina. Como o mapeamento é
+*          compartilhado com o arquivo, o sistema pode gravar as páginas em disco e
+*          liberá-las da RAM, então números maiores que a memória disponível ficam mais
+*          lentos em vez de o processo ser encerrado por falta de memória. Deve ser
+*          chamada antes de qualquer Big Number ser criado. Os vetores de limbs grandes
+*          dos kernels também passam a ir para arquivos nesse diretório (veja
+*          allocate_storage_array()).
+*
+* @return true, se o arquivo foi criado.
+*/
+
+static bool enable_file_storage(const char *directory) {
+    int fd = create_storage_file(directory);
+
+    if (fd < 0) {
+        perror("Erro ao criar o armazenamento em arquivo");
+        return false;
+    }
+
+    char* directory_copy = malloc(strlen(directory) + 1);
+
+    strcpy(directory_copy, directory);
+
+    pthread_mutex_lock(&storage_mutex);
+    storage_fd = fd;
+    storage_directory = directory_copy;
+    file_storage_enabled = true;
+    pthread_mutex_unlock(&storage_mutex);
+
+    return true;
+}
+
+
+/*
+* @brief Indica se os Nós estão sendo guardados em arquivo.
+*/
+
+bool is_file_storage_enabled() {
+    return file_storage_enabled;
+}
+
+
+/*
+* @brief Mapeia um novo bloco do arquivo de armazenamento.
+*
+* @details O arquivo cresce STORAGE_CHUNK_SIZE bytes por vez. Deve ser chamada com
+*          storage_mutex travado.
+*
+* @return true, se o bloco foi mapeado.
+*/
+
+static bool map_storage_chunk() {
+    off_t storage_size = (off_t) num_storage_chunks * STORAGE_CHUNK_SIZE;
+    char** chunks = realloc(storage_chunks, sizeof(char*) * (num_storage_chunks + 1));
+
+    if (chunks == NULL) return false;
+
+    storage_chunks = chunks;
+
+    if (ftruncate(storage_fd, storage_size + STORAGE_CHUNK_SIZE) != 0) return false;
+
+    void* chunk = mmap(NULL, STORAGE_CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, storage_fd, storage_size);
+
+    if (chunk == MAP_FAILED) {
+        if (ftruncate(storage_fd, storage_size) != 0) perror("Erro ao reduzir o armazenamento em arquivo");
+        return false;
+    }
+
+    storage_chunks[num_storage_chunks++] = chunk;
+    current_chunk_used = 0;
+
+    return true;
+}
+
+
+/*
+* @brief Devolve todos os blocos mapeados e reduz o arquivo a zero bytes.
+*
+* @details Só pode ser chamada com storage_mutex travado e quando nenhum Nó estiver em
+*          uso (nem guardado no cache de alguma thread).
+*/
+
+static void shrink_storage() {
+    for (int i = 0; i < num_storage_chunks; i++) munmap(storage_chunks[i], STORAGE_CHUNK_SIZE);
+
+    free(storage_chunks);
+    storage_chunks = NULL;
+    num_storage_chunks = 0;
+    current_chunk_used = STORAGE_CHUNK_SIZE;
+    free_nodes = NULL;
+
+    if (ftruncate(storage_fd, 0) != 0) perror("Erro ao reduzir o armazenamento em arquivo");
+}
+
+
+/*
+* @brief Enche o cache de Nós livres da thread atual.
+*
+* @details Pega até STORAGE_CACHE_NODES Nós de uma vez, primeiro da lista de Nós livres
+*          e depois do bloco mapeado atual, travando storage_mutex só uma vez. Os Nós novos
+*          são ligados em ordem de endereço, então um número criado logo em seguida ocupa
+*          Nós vizinhos no arquivo.
+*/
+
+static void refill_node_cache() {
+    pthread_mutex_lock(&storage_mutex);
+
+    int count = 0;
+
+    while (count < STORAGE_CACHE_NODES && free_nodes != NULL) {
+        Node node = free_nodes;
+
+        free_nodes = node->next_digit;
+        node->next_digit = NULL;
+
+        if (last_cached_node == NULL) cached_nodes = node;
+        else last_cached_node->next_digit = node;
+
+        last_cached_node = node;
+        count++;
+    }
+
+    while (count < STORAGE_CACHE_NODES) {
+        if (current_chunk_used + sizeof(struct Node) > STORAGE_CHUNK_SIZE && !map_storage_chunk()) {
+            if (count > 0) break;
+
+            pthread_mutex_unlock(&storage_mutex);
+            perror("Erro ao aumentar o armazenamento em arquivo");
+            abort();
+        }
+
+        Node node = (Node)(storage_chunks[num_storage_chunks - 1] + current_chunk_used);
+
+        current_chunk_used += sizeof(struct Node);
+        node->next_digit = NULL;
+
+        if (last_cached_node == NULL) cached_nodes = node;
+        else last_cached_node->next_digit = node;
+
+        last_cached_node = node;
+        count++;
+    }
+
+    nodes_in_use += count;
+    num_cached_nodes += count;
+
+    pthread_mutex_unlock(&storage_mutex);
+}
+
+
+/*
+* @brief Devolve o cache de Nós livres da thread atual para a lista de Nós livres.
+*
+* @details Deve ser chamada com storage_mutex travado.
+*/
+
+static void return_node_cache() {
+    if (cached_nodes == NULL) return;
+
+    last_cached_node->next_digit = free_nodes;
+    free_nodes = cached_nodes;
+    nodes_in_use -= num_cached_nodes;
+
+    cached_nodes = NULL;
+    last_cached_node = NULL;
+    num_cached_nodes = 0;
+}
+
+
+/*
+* @brief Aloca um Nó.
+*
+* @details No modo padrão, usa malloc(). No modo em arquivo, pega o próximo Nó do cache
+*          da thread atual, que é reabastecido em lotes (veja refill_node_cache()), então
+*          storage_mutex não é travado a cada dígito.
+*
+* @return O Nó alocado (com os campos não inicializados).
+*/
+
+Node allocate_node() {
+    if (!file_storage_enabled) return (Node)malloc(sizeof(struct Node));
+
+    if (cached_nodes == NULL) refill_node_cache();
+
+    Node node = cached_nodes;
+
+    cached_nodes = node->next_digit;
+    num_cached_nodes--;
+
+    if (cached_nodes == NULL) last_cached_node = NULL;
+
+    return node;
+}
+
+
+/*
+* @brief Libera um Nó alocado por allocate_node().
+*
+* @param node Nó a ser liberado.
+*
+* @details No modo em arquivo, o Nó volta para o cache da thread atual, que só é
+*          devolvido para a lista de Nós livres quando passa de 2 * STORAGE_CACHE_NODES Nós.
+*/
+
+void release_node(Node node) {
+    if (!file_storage_enabled) {
+        free(node);
+        return;
+    }
+
+    node->next_digit = cached_nodes;
+    cached_nodes = node;
+    num_cached_nodes++;
+
+    if (last_cached_node == NULL) last_cached_node = node;
+
+    if (num_cached_nodes > 2 * STORAGE_CACHE_NODES) {
+        pthread_mutex_lock(&storage_mutex);
+        return_node_cache();
+        pthread_mutex_unlock(&storage_mutex);
+    }
+}
+
+
+/*
+* @brief Libera uma lista encadeada de Nós.
+*
+* @param first Primeiro Nó da lista.
+* @param last Último Nó da lista.
+* @param count Quantidade de Nós da lista.
+*
+* @details No modo em arquivo, a lista inteira e o cache da thread atual são colocados
+*          de uma vez na lista de Nós livres, sem percorrer a lista, evitando tocar em
+*          páginas que já foram para o disco. A lista entra na ordem dos dígitos, então
+*          o próximo número a reaproveitá-la ocupa os Nós na mesma ordem. Quando nenhum
+*          Nó fica em uso, o arquivo é reduzido a zero bytes.
+*/
+
+void release_node_list(Node first, Node last, int count) {
+    if (first == NULL) return;
+
+    if (!file_storage_enabled) {
+        while (first != NULL) {
+            Node next = first->next_digit;
+            free(first);
+            first = next;
+        }
+
+        return;
+    }
+
+    pthread_mutex_lock(&storage_mutex);
+
+    last->next_digit = free_nodes;
+    free_nodes = first;
+    nodes_in_use -= count;
+
+    return_node_cache();
+
+    if (nodes_in_use == 0) shrink_storage();
+
+    pthread_mutex_unlock(&storage_mutex);
+}
+
+
+/*
+* @brief Aloca um vetor de trabalho dos kernels (limbs, colunas, coeficientes da NTT).
+*
+* @param size Tamanho do vetor em bytes.
+* @param is_sequential Indica se o vetor é percorrido em ordem (do início para o fim).
+*
+* @details No modo em arquivo, vetores com pelo menos STORAGE_ARRAY_MIN_SIZE bytes ficam em
+*          um arquivo temporário próprio, mapeado na memória, que o sistema pode gravar em
+*          disco em vez de encerrar o processo por falta de memória. Os vetores percorridos
+*          em ordem recebem POSIX_MADV_SEQUENTIAL, para que a leitura antecipada traga as
+*          próximas páginas e as já usadas sejam liberadas primeiro. Os Nós não recebem essa
+*          dica porque são reaproveitados fora de ordem. Nos outros casos, usa calloc().
+*
+* @return O vetor alocado, com todos os bytes zerados.
+*/
+
+void* allocate_storage_array(size_t size, bool is_sequential) {
+    if (!file_storage_enabled || size < STORAGE_ARRAY_MIN_SIZE) return calloc(size, 1);
+
+    int fd = create_storage_file(storage_directory);
+    void* array = MAP_FAILED;
+
+    if (fd >= 0 && ftruncate(fd, size) == 0) {
+        array = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+
+    if (fd >= 0) close(fd);
+
+    if (array == MAP_FAILED) {
+        perror("Erro ao aumentar o armazenamento em arquivo");
+        abort();
+    }
+
+    if (is_sequential) posix_madvise(array, size, POSIX_MADV_SEQUENTIAL);
+
+    return array;
+}
+
+
+/*
+* @brief Libera um vetor alocado por allocate_storage_array().
+*
+* @param array Vetor a ser liberado.
+* @param size Tamanho do vetor em bytes (o mesmo passado na alocação).
+*/
+
+void release_storage_array(void *array, size_t size) {
+    if (!file_storage_enabled || size < STORAGE_ARRAY_MIN_SIZE) free(array);
+    else munmap(array, size);
+}
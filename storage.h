@@ -0,0 +1,22 @@
+#ifndef storage_h
+#define storage_h
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "bignumber.h"
+
+#define STORAGE_CHUNK_SIZE (64 * 1024 * 1024)
+#define STORAGE_CACHE_NODES 4096
+#define STORAGE_ARRAY_MIN_SIZE (1024 * 1024)
+
+bool initialize_storage();
+bool is_file_storage_enabled();
+
+Node allocate_node();
+void release_node(Node node);
+void release_node_list(Node first, Node last, int count);
+
+void* allocate_storage_array(size_t size, bool is_sequential);
+void release_storage_array(void *array, size_t size);
+
+#endif
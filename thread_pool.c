@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "budget.h"
+#include "thread_pool.h"
+#include "tuning.h"
+
+
+typedef struct Job {
+    ParallelTask task;
+    void *context;
+    int count;
+    int next_index;
+    int completed;
+    RequestState request;
+    struct Job *next;
+}* Job;
+
+
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_available = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t job_finished = PTHREAD_COND_INITIALIZER;
+static Job job_queue = NULL;
+static int num_workers = -1;
+
+
+/*
+* @brief Retorna a quantidade de threads usada pelas operações paralelas.
+*
+* @details Usa a variável de ambiente BIGNUMBER_THREADS, se definida; senão, o valor
+*          "threads" do arquivo de configuração; e, se ele for 0, a quantidade de núcleos
+*          disponíveis.
+*
+* @return Quantidade de threads (no mínimo 1).
+*/
+
+int get_thread_count() {
+    const char* env_threads = getenv("BIGNUMBER_THREADS");
+    int count = (env_threads != NULL) ? atoi(env_threads) : bignumber_thresholds.threads;
+
+    if (count <= 0) count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? count : 1;
+}
+
+
+/*
+* @brief Pega o próximo índice ainda não executado de um trabalho.
+*
+* @param job Trabalho com índices pendentes. Deve ser chamada com pool_mutex travado.
+*
+* @details Quando o último índice é pego, o trabalho sai da fila, para que as threads
+*          passem para o próximo.
+*
+* @return Índice a ser executado.
+*/
+
+static int take_job_index(Job job) {
+    int index = job->next_index++;
+
+    if (job->next_index == job->count) {
+        Job* link = &job_queue;
+
+        while (*link != job) link = &(*link)->next;
+
+        *link = job->next;
+    }
+
+    return index;
+}
+
+
+/*
+* @brief Executa um índice de um trabalho e registra sua conclusão.
+*
+* @param job Trabalho ao qual o índice pertence. Deve ser chamada com pool_mutex travado.
+* @param index Índice a ser executado.
+*
+* @details A tarefa roda com a mesma requisição de quem criou o trabalho, para que os
+*          pontos de cancelamento valham também dentro das threads do pool.
+*/
+
+static void run_job_index(Job job, int index) {
+    RequestState previous_request = get_current_request();
+
+    pthread_mutex_unlock(&pool_mutex);
+    set_current_request(job->request);
+    job->task(job->context, index);
+    set_current_request(previous_request);
+    pthread_mutex_lock(&pool_mutex);
+
+    job->completed++;
+
+    if (job->completed == job->count) pthread_cond_broadcast(&job_finished);
+}
+
+
+/*
+* @brief Laço das threads do pool, que executam índices dos trabalhos da fila.
+*
+* @return NULL (as threads nunca terminam).
+*/
+
+static void* thread_pool_worker(void *argument) {
+    (void) argument;
+
+    pthread_mutex_lock(&pool_mutex);
+
+    while (1) {
+        while (job_queue == NULL) pthread_cond_wait(&work_available, &pool_mutex);
+
+        Job job = job_queue;
+        run_job_index(job, take_job_index(job));
+    }
+
+    return NULL;
+}
+
+
+/*
+* @brief Cria as threads do pool na primeira chamada. Deve ser chamada com pool_mutex travado.
+*
+* @details O pool é compartilhado por todas as operações do processo (inclusive entre os
+*          clientes do servidor) e tem get_thread_count() - 1 threads, já que a thread que
+*          chama bignumber_parallel_for() também executa tarefas.
+*/
+
+static void start_thread_pool() {
+    if (num_workers >= 0) return;
+
+    num_workers = 0;
+
+    for (int i = 1; i < get_thread_count(); i++) {
+        pthread_t thread;
+
+        if (pthread_create(&thread, NULL, thread_pool_worker, NULL) != 0) break;
+
+        pthread_detach(thread);
+        num_workers++;
+    }
+}
+
+
+/*
+* @brief Executa task(context, i) para todo i em [0, count), em paralelo.
+*
+* @param task Função a ser executada para cada índice.
+* @param context Dados compartilhados pelas tarefas.
+* @param count Quantidade de índices.
+*
+* @details A thread que chama também executa índices do próprio trabalho enquanto houver
+*          algum pendente, e só então espera os que estão com outras threads. Por isso,
+*          bignumber_parallel_for() pode ser chamada de dentro de uma tarefa sem risco de deadlock.
+*          Retorna somente depois que todos os índices terminaram.
+*/
+
+void bignumber_parallel_for(ParallelTask task, void *context, int count) {
+    if (count <= 0) return;
+
+    pthread_mutex_lock(&pool_mutex);
+    start_thread_pool();
+
+    if (num_workers == 0 || count == 1) {
+        pthread_mutex_unlock(&pool_mutex);
+
+        for (int i = 0; i < count; i++) task(context, i);
+
+        return;
+    }
+
+    struct Job job = {task, context, count, 0, 0, get_current_request(), NULL};
+    Job* link = &job_queue;
+
+    while (*link != NULL) link = &(*link)->next;
+
+    *link = &job;
+    pthread_cond_broadcast(&work_available);
+
+    while (job.completed < job.count) {
+        if (job.next_index < job.count) {
+            run_job_index(&job, take_job_index(&job));
+        }
+
+        else {
+            pthread_cond_wait(&job_finished, &pool_mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&pool_mutex);
+}
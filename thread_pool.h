@@ -0,0 +1,9 @@
+#ifndef thread_pool_h
+#define thread_pool_h
+
+typedef void (*ParallelTask)(void *context, int index);
+
+int get_thread_count();
+void bignumber_parallel_for(ParallelTask task, void *context, int count);
+
+#endif
@@ -0,0 +1,330 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include "auxiliar.h"
+#include "bignumber.h"
+#include "ntt.h"
+#include "thread_pool.h"
+#include "tuning.h"
+
+
+Thresholds bignumber_thresholds = {
+    DEFAULT_KARATSUBA_THRESHOLD,
+    DEFAULT_DOT_PRODUCT_SCHOOLBOOK_LIMIT,
+    DEFAULT_NTT_THRESHOLD,
+    DEFAULT_PARALLEL_THRESHOLD,
+    DEFAULT_THREADS,
+    DEFAULT_FIXED_WIDTH_BITS
+};
+
+
+/*
+* @brief Retorna o caminho do arquivo de configuração dos limiares.
+*
+* @details Usa a variável de ambiente BIGNUMBER_CONFIG, se definida; caso contrário,
+*          usa DEFAULT_CONFIG_PATH no diretório atual.
+*
+* @return Caminho do arquivo de configuração.
+*/
+
+const char* get_config_path() {
+    const char* path = getenv("BIGNUMBER_CONFIG");
+
+    return (path != NULL && *path != '\0') ? path : DEFAULT_CONFIG_PATH;
+}
+
+
+/*
+* @brief Carrega os limiares de troca de algoritmo de um arquivo de configuração.
+*
+* @param path Caminho do arquivo.
+*
+* @details Cada linha tem o formato "nome = valor". Linhas começando com '#' e nomes
+*          desconhecidos são ignorados, e valores negativos (ou zero, exceto para "threads"
+*          e "fixed_width_bits", em que zero desliga o recurso) mantêm o padrão. Se o
+*          arquivo não existir, os valores padrão são mantidos.
+*
+* @return true, se o arquivo foi lido.
+*/
+
+bool load_thresholds(const char *path) {
+    FILE* file = fopen(path, "r");
+
+    if (file == NULL) return false;
+
+    char line[256];
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char name[64];
+        int value;
+
+        if (line[0] == '#' || sscanf(line, " %63[a-z_] = %d", name, &value) != 2 || value < 0) continue;
+
+        if (strcmp(name, "threads") == 0) bignumber_thresholds.threads = value;
+        else if (strcmp(name, "fixed_width_bits") == 0) bignumber_thresholds.fixed_width_bits = value;
+        else if (value == 0) continue;
+        else if (strcmp(name, "karatsuba_threshold") == 0) bignumber_thresholds.karatsuba = value;
+        else if (strcmp(name, "dot_product_schoolbook_limit") == 0) bignumber_thresholds.dot_product_schoolbook = value;
+        else if (strcmp(name, "ntt_threshold") == 0) bignumber_thresholds.ntt = value;
+        else if (strcmp(name, "parallel_threshold") == 0) bignumber_thresholds.parallel = value;
+    }
+
+    fclose(file);
+
+    return true;
+}
+
+
+/*
+* @brief Salva os limiares atuais em um arquivo de configuração.
+*
+* @param path Caminho do arquivo.
+*
+* @return true, se o arquivo foi escrito.
+*/
+
+static bool save_thresholds(const char *path) {
+    FILE* file = fopen(path, "w");
+
+    if (file == NULL) return false;
+
+    fprintf(file, "# Limiares medidos por client.exe --tune\n");
+    fprintf(file, "karatsuba_threshold = %d\n", bignumber_thresholds.karatsuba);
+    fprintf(file, "dot_product_schoolbook_limit = %d\n", bignumber_thresholds.dot_product_schoolbook);
+    fprintf(file, "ntt_threshold = %d\n", bignumber_thresholds.ntt);
+    fprintf(file, "parallel_threshold = %d\n", bignumber_thresholds.parallel);
+    fprintf(file, "threads = %d\n", bignumber_thresholds.threads);
+    fprintf(file, "fixed_width_bits = %d\n", bignumber_thresholds.fixed_width_bits);
+
+    return fclose(file) == 0;
+}
+
+
+/*
+* @brief Cria um Big Number positivo com dígitos aleatórios.
+*
+* @param num_digits Quantidade de dígitos.
+*
+* @return O Big Number criado (o primeiro dígito nunca é zero).
+*/
+
+static BigNumber create_random_big_number(int num_digits) {
+    BigNumber x = create_big_number("");
+
+    for (int i = 0; i < num_digits; i++) {
+        int digit = rand() % 10;
+
+        if (i == 0 && digit == 0) digit = 1;
+
+        add_node_to_big_number(x, digit, true);
+    }
+
+    return x;
+}
+
+
+/*
+* @brief Retorna o tempo atual em segundos, de um relógio monotônico.
+*/
+
+static double get_time_in_seconds() {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+/*
+* @brief Mede o tempo médio de uma multiplicação.
+*
+* @param multiply Função de multiplicação a ser medida.
+* @param x Big Number a ser multiplicado.
+* @param y Big Number a ser multiplicado.
+*
+* @details A multiplicação é repetida até somar pelo menos 20 ms, para reduzir o ruído.
+*
+* @return Tempo médio de uma chamada, em segundos.
+*/
+
+static double time_multiplication(BigNumber (*multiply)(BigNumber, BigNumber), BigNumber x, BigNumber y) {
+    int repetitions = 0;
+    double start = get_time_in_seconds();
+    double elapsed;
+
+    do {
+        free_big_number(multiply(x, y));
+        repetitions++;
+        elapsed = get_time_in_seconds() - start;
+    } while (elapsed < 0.02);
+
+    return elapsed / repetitions;
+}
+
+
+/*
+* @brief Mede o tempo médio de acumular um produto no vetor de colunas do produto escalar.
+*
+* @param x Big Number a ser multiplicado.
+* @param y Big Number a ser multiplicado.
+* @param columns Vetor de colunas com espaço para o produto.
+*
+* @return Tempo médio de uma chamada, em segundos.
+*/
+
+static double time_product_accumulation(BigNumber x, BigNumber y, long long *columns) {
+    int repetitions = 0;
+    double start = get_time_in_seconds();
+    double elapsed;
+
+    do {
+        accumulate_product_of_big_numbers(columns, x, y);
+        repetitions++;
+        elapsed = get_time_in_seconds() - start;
+    } while (elapsed < 0.02);
+
+    return elapsed / repetitions;
+}
+
+
+/*
+* @brief Mede os pontos de troca entre algoritmos nesta máquina e os salva.
+*
+* @param path Caminho do arquivo de configuração a ser escrito.
+*
+* @details Para o Karatsuba, cada tamanho candidato t é testado multiplicando números de
+*          2t dígitos: uma vez dividindo em metades de t dígitos resolvidas pelo método
+*          tradicional, e outra vez só pelo método tradicional. O limiar é o primeiro t em
+*          que a divisão compensa. Para o produto escalar, o acúmulo direto nas colunas é
+*          comparado com o produto por Karatsuba seguido do acúmulo. Depois, o Karatsuba é
+*          comparado com a NTT, e a NTT serial com a paralela (só quando há mais de uma thread).
+*          Os algoritmos de tamanho fixo ficam desligados durante as medições, para que os
+*          tempos sejam de fato os do Karatsuba e do método tradicional; o valor configurado
+*          de "fixed_width_bits" é mantido no arquivo.
+*
+* @return int 0 em caso de sucesso, 1 se o arquivo não puder ser escrito.
+*/
+
+int run_tuning(const char *path) {
+    static const int sizes[] = {4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024};
+    const int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    srand(12345);
+
+    Thresholds tuned = bignumber_thresholds;
+    tuned.karatsuba = sizes[num_sizes - 1];
+    bignumber_thresholds.fixed_width_bits = 0;
+
+    for (int i = 0; i < num_sizes; i++) {
+        BigNumber x = create_random_big_number(2 * sizes[i]);
+        BigNumber y = create_random_big_number(2 * sizes[i]);
+
+        bignumber_thresholds.karatsuba = sizes[i];
+        double karatsuba_time = time_multiplication(multiply_karatsuba_big_numbers, x, y);
+        double schoolbook_time = time_multiplication(multiply_big_numbers, x, y);
+
+        free_big_number(x);
+        free_big_number(y);
+
+        fprintf(stderr, "karatsuba %5d digitos: tradicional %.6fs, karatsuba %.6fs\n",
+                2 * sizes[i], schoolbook_time, karatsuba_time);
+
+        if (karatsuba_time < schoolbook_time) {
+            tuned.karatsuba = sizes[i];
+            break;
+        }
+    }
+
+    bignumber_thresholds.karatsuba = tuned.karatsuba;
+    tuned.dot_product_schoolbook = sizes[num_sizes - 1];
+
+    for (int i = 0; i < num_sizes; i++) {
+        BigNumber x = create_random_big_number(sizes[i]);
+        BigNumber y = create_random_big_number(sizes[i]);
+        long long* columns = calloc(2 * sizes[i] + 20, sizeof(long long));
+
+        bignumber_thresholds.dot_product_schoolbook = sizes[i];
+        double direct_time = time_product_accumulation(x, y, columns);
+
+        bignumber_thresholds.dot_product_schoolbook = 0;
+        double karatsuba_time = time_product_accumulation(x, y, columns);
+
+        free_big_number(x);
+        free_big_number(y);
+        free(columns);
+
+        fprintf(stderr, "produto escalar %5d digitos: direto %.6fs, karatsuba %.6fs\n",
+                sizes[i], direct_time, karatsuba_time);
+
+        if (karatsuba_time < direct_time) {
+            tuned.dot_product_schoolbook = sizes[i];
+            break;
+        }
+    }
+
+    bignumber_thresholds.dot_product_schoolbook = tuned.dot_product_schoolbook;
+    tuned.ntt = 16 * sizes[num_sizes - 1];
+
+    for (int size = sizes[0]; size <= 16 * sizes[num_sizes - 1]; size *= 2) {
+        BigNumber x = create_random_big_number(size);
+        BigNumber y = create_random_big_number(size);
+
+        bignumber_thresholds.ntt = INT_MAX;
+        double karatsuba_time = time_multiplication(multiply_karatsuba_big_numbers, x, y);
+        double ntt_time = time_multiplication(multiply_ntt_big_numbers, x, y);
+
+        free_big_number(x);
+        free_big_number(y);
+
+        fprintf(stderr, "ntt %5d digitos: karatsuba %.6fs, ntt %.6fs\n", size, karatsuba_time, ntt_time);
+
+        if (ntt_time < karatsuba_time) {
+            tuned.ntt = size;
+            break;
+        }
+    }
+
+    bignumber_thresholds.ntt = tuned.ntt;
+
+    if (get_thread_count() > 1) {
+        tuned.parallel = NTT_MAX_LENGTH;
+
+        for (int length = 4 * NTT_PARALLEL_CHUNK; length < NTT_MAX_LENGTH; length *= 2) {
+            int size = length * NTT_BASE_DIGITS / 2;
+            BigNumber x = create_random_big_number(size);
+            BigNumber y = create_random_big_number(size);
+
+            bignumber_thresholds.parallel = INT_MAX;
+            double serial_time = time_multiplication(multiply_ntt_big_numbers, x, y);
+
+            bignumber_thresholds.parallel = 0;
+            double parallel_time = time_multiplication(multiply_ntt_big_numbers, x, y);
+
+            free_big_number(x);
+            free_big_number(y);
+
+            fprintf(stderr, "paralelo %8d digitos: serial %.6fs, paralelo %.6fs\n", size, serial_time, parallel_time);
+
+            if (parallel_time < serial_time) {
+                tuned.parallel = length;
+                break;
+            }
+        }
+    }
+
+    bignumber_thresholds = tuned;
+
+    if (!save_thresholds(path)) {
+        fprintf(stderr, "Não foi possível escrever %s\n", path);
+        return 1;
+    }
+
+    fprintf(stderr, "Limiares salvos em %s\n", path);
+
+    return 0;
+}
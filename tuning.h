@@ -0,0 +1,30 @@
+#ifndef tuning_h
+#define tuning_h
+
+#include <stdbool.h>
+
+#define DEFAULT_CONFIG_PATH "bignumber.conf"
+
+#define DEFAULT_KARATSUBA_THRESHOLD 64
+#define DEFAULT_DOT_PRODUCT_SCHOOLBOOK_LIMIT 1024
+#define DEFAULT_NTT_THRESHOLD 256
+#define DEFAULT_PARALLEL_THRESHOLD 65536
+#define DEFAULT_THREADS 0
+#define DEFAULT_FIXED_WIDTH_BITS 4096
+
+typedef struct Thresholds {
+    int karatsuba;
+    int dot_product_schoolbook;
+    int ntt;
+    int parallel;
+    int threads;
+    int fixed_width_bits;
+} Thresholds;
+
+extern Thresholds bignumber_thresholds;
+
+const char* get_config_path();
+bool load_thresholds(const char *path);
+int run_tuning(const char *path);
+
+#endif
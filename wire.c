@@ -0,0 +1,704 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "auxiliar.h"
+#include "bignumber.h"
+#include "budget.h"
+#include "limbs.h"
+#include "ntt.h"
+#include "storage.h"
+#include "wire.h"
+
+
+/*
+* @brief Adiciona bytes ao final de um buffer, aumentando sua capacidade se necessário.
+*
+* @param buffer Buffer de destino.
+* @param bytes Bytes a serem copiados.
+* @param size Quantidade de bytes.
+*/
+
+void append_bytes(ByteBuffer *buffer, const void *bytes, size_t size) {
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = (buffer->capacity > 0) ? buffer->capacity : 4096;
+
+        while (buffer->size + size > capacity) capacity *= 2;
+
+        buffer->data = realloc(buffer->data, capacity);
+        buffer->capacity = capacity;
+    }
+
+    memcpy(buffer->data + buffer->size, bytes, size);
+    buffer->size += size;
+}
+
+
+/*
+* @brief Escreve um inteiro de 32 bits em little-endian.
+*
+* @param bytes Destino com pelo menos 4 bytes.
+* @param value Valor a ser escrito.
+*/
+
+void store_uint32_le(unsigned char *bytes, uint32_t value) {
+    bytes[0] = value & 0xFF;
+    bytes[1] = (value >> 8) & 0xFF;
+    bytes[2] = (value >> 16) & 0xFF;
+    bytes[3] = (value >> 24) & 0xFF;
+}
+
+
+/*
+* @brief Lê um inteiro de 32 bits em little-endian.
+*
+* @param bytes Origem com pelo menos 4 bytes.
+*
+* @return Valor lido.
+*/
+
+uint32_t load_uint32_le(const unsigned char *bytes) {
+    return (uint32_t) bytes[0] | ((uint32_t) bytes[1] << 8) |
+           ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+
+/*
+* @brief Adiciona o registro binário de um Big Number ao buffer.
+*
+* @param buffer Buffer de destino.
+* @param x Big Number a ser escrito, ou NULL para um registro vazio.
+*/
+
+void append_big_number_record(ByteBuffer *buffer, BigNumber x) {
+    unsigned char header[5] = {0, 0, 0, 0, 0};
+
+    if (x == NULL || x->num_digits == 0) {
+        append_bytes(buffer, header, sizeof(header));
+        return;
+    }
+
+    size_t limbs_size = sizeof(Limb) * limbs_length_for_digits(x->num_digits);
+    Limb* limbs = allocate_storage_array(limbs_size, true);
+    int count = big_number_to_limbs(x, limbs);
+
+    header[0] = x->is_positive ? 0 : 1;
+    store_uint32_le(header + 1, count);
+    append_bytes(buffer, header, sizeof(header));
+
+    for (int i = 0; i < count; i++) {
+        unsigned char bytes[4];
+
+        store_uint32_le(bytes, limbs[i]);
+        append_bytes(buffer, bytes, sizeof(bytes));
+    }
+
+    release_storage_array(limbs, limbs_size);
+}
+
+
+/*
+* @brief Lê um registro binário de Big Number.
+*
+* @param data Início dos dados da entrada.
+* @param size Tamanho total dos dados.
+* @param offset Posição do registro, que é avançada até o fim dele.
+*
+* @return O Big Number lido, ou NULL se o registro estiver incompleto ou inválido.
+*/
+
+BigNumber read_big_number_record(const unsigned char *data, size_t size, size_t *offset) {
+    if (size - *offset < 5) return NULL;
+
+    bool is_positive = data[*offset] == 0;
+    uint32_t count = load_uint32_le(data + *offset + 1);
+
+    if (count > (size - *offset - 5) / 4) return NULL;
+
+    const unsigned char* limb_bytes = data + *offset + 5;
+    size_t limbs_size = sizeof(Limb) * ((size_t) count + 1);
+    Limb* limbs = allocate_storage_array(limbs_size, true);
+
+    for (uint32_t i = 0; i < count; i++) {
+        limbs[i] = load_uint32_le(limb_bytes + 4 * i);
+
+        if (limbs[i] >= LIMB_BASE) {
+            release_storage_array(limbs, limbs_size);
+            return NULL;
+        }
+    }
+
+    BigNumber x = create_big_number_from_limbs(limbs, count, is_positive);
+
+    *offset += 5 + 4 * (size_t) count;
+    release_storage_array(limbs, limbs_size);
+
+    return x;
+}
+
+
+/*
+* @brief Multiplica dois vetores de limbs em uma base qualquer (até 2^16).
+*
+* @param x Limbs do primeiro operando, do menos para o mais significativo.
+* @param length_x Quantidade de limbs do primeiro operando.
+* @param y Limbs do segundo operando.
+* @param length_y Quantidade de limbs do segundo operando.
+* @param base Base dos limbs.
+* @param result Vetor de destino, com length_x + length_y limbs.
+*
+* @details Operandos pequenos são multiplicados pelo método escolar; os demais, pela
+*          convolução da NTT, com o transporte propagado na base dos limbs.
+*/
+
+void multiply_limbs_in_base(const uint32_t *x, int length_x, const uint32_t *y, int length_y, uint32_t base, uint32_t *result) {
+    int length = length_x + length_y;
+    int shortest = (length_x < length_y) ? length_x : length_y;
+
+    if (shortest < BASE_CONVERSION_NTT_LIMBS || length > NTT_MAX_LENGTH) {
+        memset(result, 0, sizeof(uint32_t) * length);
+
+        for (int i = 0; i < length_x; i++) {
+            uint64_t carry = 0;
+
+            for (int j = 0; j < length_y; j++) {
+                uint64_t value = (uint64_t) x[i] * y[j] + result[i + j] + carry;
+
+                result[i + j] = value % base;
+                carry = value / base;
+            }
+
+            result[i + length_y] = carry;
+        }
+
+        return;
+    }
+
+    int num_coefficients;
+    uint64_t* coefficients = convolve_ntt_limbs(x, length_x, y, length_y, &num_coefficients);
+    uint64_t carry = 0;
+
+    for (int i = 0; i < length; i++) {
+        uint64_t value = ((i < num_coefficients) ? coefficients[i] : 0) + carry;
+
+        result[i] = value % base;
+        carry = value / base;
+    }
+
+    release_storage_array(coefficients, sizeof(uint64_t) * num_coefficients);
+}
+
+
+/*
+* @brief Remove os limbs nulos mais significativos de um vetor (deixando pelo menos um).
+*/
+
+int trim_limbs(const uint32_t *limbs, int length) {
+    while (length > 1 && limbs[length - 1] == 0) length--;
+
+    return length;
+}
+
+
+/*
+* @brief Converte um bloco pequeno de limbs para outra base pelo método de Horner.
+*
+* @param limbs Limbs na base de origem, do menos para o mais significativo.
+* @param length Quantidade de limbs.
+* @param from_base Base de origem.
+* @param to_base Base de destino.
+* @param result_length Recebe a quantidade de limbs do resultado.
+*
+* @return Vetor alocado dinamicamente com os limbs na base de destino.
+*/
+
+uint32_t* convert_limbs_by_horner(const uint32_t *limbs, int length, uint32_t from_base, uint32_t to_base, int *result_length) {
+    uint32_t* result = malloc(sizeof(uint32_t) * (2 * length + 1));
+    int count = 1;
+
+    result[0] = 0;
+
+    for (int i = length - 1; i >= 0; i--) {
+        uint64_t carry = limbs[i];
+
+        for (int j = 0; j < count; j++) {
+            uint64_t value = (uint64_t) result[j] * from_base + carry;
+
+            result[j] = value % to_base;
+            carry = value / to_base;
+        }
+
+        while (carry > 0) {
+            result[count++] = carry % to_base;
+            carry /= to_base;
+        }
+    }
+
+    *result_length = count;
+
+    return result;
+}
+
+
+/*
+* @brief Converte um vetor de limbs para outra base por divisão e conquista.
+*
+* @param limbs Limbs na base de origem, do menos para o mais significativo.
+* @param length Quantidade de limbs (no máximo BASE_CONVERSION_BLOCK << (level + 1)).
+* @param from_base Base de origem.
+* @param to_base Base de destino.
+* @param powers powers[k] é from_base ^ (BASE_CONVERSION_BLOCK << k) escrito na base de destino.
+* @param power_lengths Quantidade de limbs de cada potência.
+* @param level Maior nível de divisão permitido.
+* @param result_length Recebe a quantidade de limbs do resultado.
+*
+* @details O vetor é dividido em uma parte baixa com BASE_CONVERSION_BLOCK << level limbs e
+*          uma parte alta, convertidas recursivamente; o resultado é alta * powers[level] + baixa.
+*          Com as multiplicações pela NTT, a conversão fica em O(M(n) log n), em vez de O(n²).
+*
+* @return Vetor alocado dinamicamente com os limbs na base de destino.
+*/
+
+uint32_t* convert_limbs_base(const uint32_t *limbs, int length, uint32_t from_base, uint32_t to_base,
+                             uint32_t **powers, const int *power_lengths, int level, int *result_length) {
+    if (length <= BASE_CONVERSION_BLOCK) {
+        return convert_limbs_by_horner(limbs, length, from_base, to_base, result_length);
+    }
+
+    int low_length = BASE_CONVERSION_BLOCK << level;
+
+    while (low_length >= length) {
+        level--;
+        low_length >>= 1;
+    }
+
+    int converted_low_length;
+    int converted_high_length;
+    uint32_t* low = convert_limbs_base(limbs, low_length, from_base, to_base, powers, power_lengths, level - 1, &converted_low_length);
+    uint32_t* high = convert_limbs_base(limbs + low_length, length - low_length, from_base, to_base, powers, power_lengths, level - 1, &converted_high_length);
+
+    int count = converted_high_length + power_lengths[level];
+    uint32_t* result = malloc(sizeof(uint32_t) * (count + 1));
+    uint64_t carry = 0;
+
+    multiply_limbs_in_base(high, converted_high_length, powers[level], power_lengths[level], to_base, result);
+    result[count] = 0;
+
+    for (int i = 0; i <= count && (i < converted_low_length || carry > 0); i++) {
+        uint64_t value = (uint64_t) result[i] + ((i < converted_low_length) ? low[i] : 0) + carry;
+
+        result[i] = value % to_base;
+        carry = value / to_base;
+    }
+
+    free(low);
+    free(high);
+
+    *result_length = trim_limbs(result, count + 1);
+
+    return result;
+}
+
+
+/*
+* @brief Converte um número escrito em limbs para outra base.
+*
+* @param limbs Limbs na base de origem, do menos para o mais significativo.
+* @param length Quantidade de limbs.
+* @param from_base Base de origem.
+* @param to_base Base de destino.
+* @param result_length Recebe a quantidade de limbs do resultado.
+*
+* @details Calcula as potências from_base ^ (BASE_CONVERSION_BLOCK << k) na base de destino
+*          por quadrados sucessivos e chama convert_limbs_base().
+*
+* @return Vetor alocado dinamicamente com os limbs na base de destino.
+*/
+
+uint32_t* change_limbs_base(const uint32_t *limbs, int length, uint32_t from_base, uint32_t to_base, int *result_length) {
+    int levels = 1;
+
+    while ((BASE_CONVERSION_BLOCK << levels) < length) levels++;
+
+    uint32_t** powers = malloc(sizeof(uint32_t*) * levels);
+    int* power_lengths = malloc(sizeof(int) * levels);
+    uint32_t* block = malloc(sizeof(uint32_t) * (BASE_CONVERSION_BLOCK + 1));
+
+    for (int i = 0; i < BASE_CONVERSION_BLOCK; i++) block[i] = 0;
+    block[BASE_CONVERSION_BLOCK] = 1;
+
+    powers[0] = convert_limbs_by_horner(block, BASE_CONVERSION_BLOCK + 1, from_base, to_base, &power_lengths[0]);
+
+    for (int k = 1; k < levels; k++) {
+        int count = 2 * power_lengths[k - 1];
+
+        powers[k] = malloc(sizeof(uint32_t) * count);
+        multiply_limbs_in_base(powers[k - 1], power_lengths[k - 1], powers[k - 1], power_lengths[k - 1], to_base, powers[k]);
+        power_lengths[k] = trim_limbs(powers[k], count);
+    }
+
+    uint32_t* result = convert_limbs_base(limbs, length, from_base, to_base, powers, power_lengths, levels - 1, result_length);
+
+    for (int k = 0; k < levels; k++) free(powers[k]);
+
+    free(powers);
+    free(power_lengths);
+    free(block);
+
+    return result;
+}
+
+
+/*
+* @brief Cria um Big Number a partir de um número em hexadecimal.
+*
+* @param str_number String do número, com sinal e prefixo "0x" opcionais.
+*
+* @details Os dígitos hexadecimais são agrupados em limbs de base 2^16 (4 dígitos cada),
+*          convertidos para limbs de base NTT_BASE por change_limbs_base() e então
+*          escritos como dígitos decimais.
+*
+* @return O Big Number criado, ou NULL se houver algum caractere inválido.
+*/
+
+BigNumber create_big_number_from_hex(const char *str_number) {
+    bool is_positive = true;
+
+    if (*str_number == '-') {
+        is_positive = false;
+        str_number++;
+    }
+
+    if (str_number[0] == '0' && (str_number[1] == 'x' || str_number[1] == 'X')) str_number += 2;
+
+    size_t length = strlen(str_number);
+    int count = length / HEX_LIMB_DIGITS + 1;
+    uint32_t* limbs = calloc(count, sizeof(uint32_t));
+
+    for (size_t i = 0; i < length; i++) {
+        char character = str_number[length - 1 - i];
+
+        if (!isxdigit((unsigned char) character)) {
+            free(limbs);
+            return NULL;
+        }
+
+        uint32_t digit = isdigit((unsigned char) character) ? character - '0' :
+                         tolower((unsigned char) character) - 'a' + 10;
+
+        limbs[i / HEX_LIMB_DIGITS] |= digit << (4 * (i % HEX_LIMB_DIGITS));
+    }
+
+    int decimal_count;
+    uint32_t* decimal_limbs = change_limbs_base(limbs, trim_limbs(limbs, count), HEX_LIMB_BASE, NTT_BASE, &decimal_count);
+    BigNumber x = create_big_number("");
+
+    for (int i = 0; i < decimal_count; i++) {
+        uint32_t limb = decimal_limbs[i];
+
+        for (int j = 0; j < NTT_BASE_DIGITS; j++) {
+            add_node_to_big_number(x, limb % 10, false);
+            limb /= 10;
+        }
+    }
+
+    x->is_even = (x->last_digit->digit % 2 == 0) ? true : false;
+    remove_zeros_from_left(x);
+    x->is_positive = is_positive || (x->num_digits == 1 && x->first_digit->digit == 0);
+
+    free(decimal_limbs);
+    free(limbs);
+
+    return x;
+}
+
+
+/*
+* @brief Converte um Big Number para hexadecimal.
+*
+* @param x Big Number a ser convertido.
+*
+* @details Os dígitos são agrupados em limbs de base NTT_BASE, convertidos para limbs de
+*          base 2^16 por change_limbs_base(), e cada limb fornece 4 dígitos hexadecimais.
+*
+* @return String alocada dinamicamente com o número em hexadecimal (com '-' se negativo).
+*/
+
+char* big_number_to_hex(BigNumber x) {
+    static const char hex_digits[] = "0123456789abcdef";
+
+    uint32_t* decimal_limbs = malloc(sizeof(uint32_t) * (x->num_digits / NTT_BASE_DIGITS + 2));
+    int decimal_count = big_number_to_ntt_limbs(x, decimal_limbs);
+    int count;
+    uint32_t* limbs = change_limbs_base(decimal_limbs, trim_limbs(decimal_limbs, decimal_count), NTT_BASE, HEX_LIMB_BASE, &count);
+
+    char* hex = malloc((size_t) count * HEX_LIMB_DIGITS + 2);
+    size_t position = 0;
+    bool is_leading = true;
+
+    if (!x->is_positive) hex[position++] = '-';
+
+    for (int i = count - 1; i >= 0; i--) {
+        for (int j = HEX_LIMB_DIGITS - 1; j >= 0; j--) {
+            int digit = (limbs[i] >> (4 * j)) & 0xF;
+
+            if (is_leading && digit == 0 && (i > 0 || j > 0)) continue;
+
+            is_leading = false;
+            hex[position++] = hex_digits[digit];
+        }
+    }
+
+    hex[position] = '\0';
+
+    free(limbs);
+    free(decimal_limbs);
+
+    return hex;
+}
+
+
+/*
+* @brief Garante que a entrada binária tenha pelo menos size bytes ainda não consumidos.
+*
+* @param input Entrada binária.
+* @param size Quantidade de bytes necessária.
+*
+* @details Quando a entrada não está mapeada na memória, os bytes já consumidos são
+*          descartados e o descritor é lido até completar a quantidade pedida. A leitura
+*          só bloqueia quando os bytes já recebidos não bastam para a requisição atual.
+*
+* @return true, se os bytes estão disponíveis; false, se a entrada terminou antes.
+*/
+
+bool fill_binary_input(BinaryInput *input, size_t size) {
+    while (input->size - input->offset < size) {
+        if (input->is_mapped || input->is_finished) return false;
+
+        if (input->offset > 0) {
+            memmove(input->data, input->data + input->offset, input->size - input->offset);
+            input->size -= input->offset;
+            input->offset = 0;
+        }
+
+        if (input->capacity < size || input->capacity - input->size < BINARY_READ_SIZE) {
+            input->capacity = ((size > input->size + BINARY_READ_SIZE) ? size : input->size + BINARY_READ_SIZE);
+            input->data = realloc(input->data, input->capacity);
+        }
+
+        ssize_t bytes_read = read(input->fd, input->data + input->size, input->capacity - input->size);
+
+        if (bytes_read <= 0) {
+            input->is_finished = true;
+            return false;
+        }
+
+        input->size += bytes_read;
+    }
+
+    return true;
+}
+
+
+/*
+* @brief Descarta bytes da entrada binária sem guardá-los.
+*
+* @param input Entrada binária.
+* @param size Quantidade de bytes a descartar.
+*
+* @return true, se os bytes foram descartados; false, se a entrada terminou antes.
+*/
+
+bool skip_binary_input(BinaryInput *input, size_t size) {
+    while (size > 0) {
+        size_t available = input->size - input->offset;
+
+        if (available == 0) {
+            if (!fill_binary_input(input, 1)) return false;
+            continue;
+        }
+
+        size_t skipped = (available < size) ? available : size;
+
+        input->offset += skipped;
+        size -= skipped;
+    }
+
+    return true;
+}
+
+
+/*
+* @brief Lê o próximo registro de número da entrada binária.
+*
+* @param input Entrada binária.
+* @param max_digits Maior quantidade de dígitos aceita (0 = sem limite).
+* @param is_too_large Recebe true se o registro foi descartado por exceder max_digits.
+*
+* @return O Big Number lido, ou NULL se o registro foi descartado, está incompleto ou é inválido.
+*/
+
+BigNumber read_binary_input_record(BinaryInput *input, size_t max_digits, bool *is_too_large) {
+    *is_too_large = false;
+
+    if (!fill_binary_input(input, 5)) return NULL;
+
+    size_t count = load_uint32_le(input->data + input->offset + 1);
+
+    if (max_digits > 0 && count * LIMB_DIGITS > max_digits) {
+        *is_too_large = skip_binary_input(input, 5 + 4 * count);
+        return NULL;
+    }
+
+    if (!fill_binary_input(input, 5 + 4 * count)) return NULL;
+
+    return read_big_number_record(input->data, input->size, &input->offset);
+}
+
+
+/*
+* @brief Escreve todo o conteúdo de um buffer em um descritor e o esvazia.
+*
+* @param output_fd Descritor de destino.
+* @param output Buffer com os bytes a serem escritos.
+*/
+
+void flush_byte_buffer(int output_fd, ByteBuffer *output) {
+    size_t written = 0;
+
+    while (written < output->size) {
+        ssize_t bytes_written = write(output_fd, output->data + written, output->size - written);
+
+        if (bytes_written <= 0) break;
+        written += bytes_written;
+    }
+
+    output->size = 0;
+}
+
+
+/*
+* @brief Executa o programa no modo binário.
+*
+* @param input_fd Descritor de onde as requisições são lidas.
+* @param output_fd Descritor onde as respostas são escritas.
+*
+* @details Quando a entrada é um arquivo regular, ela é mapeada na memória com mmap() e
+*          lida diretamente; caso contrário, ela é lida aos poucos, apenas o necessário para
+*          a requisição atual. As respostas são acumuladas e escritas sempre que não há mais
+*          bytes recebidos esperando (antes de bloquear em uma nova leitura) ou quando passam
+*          de BINARY_OUTPUT_FLUSH_SIZE bytes, então um cliente interativo recebe cada resposta
+*          antes de enviar a próxima requisição. Um número maior que o orçamento de memória
+*          (veja get_max_digits_in_budget()) é descartado sem ser guardado, e a requisição
+*          recebe uma resposta de erro.
+*/
+
+void execute_binary_program(int input_fd, int output_fd) {
+    struct stat input_stat;
+    BinaryInput input = {input_fd, NULL, 0, 0, 0, false, false};
+
+    if (fstat(input_fd, &input_stat) == 0 && S_ISREG(input_stat.st_mode) && input_stat.st_size > 0) {
+        void* mapped = mmap(NULL, input_stat.st_size, PROT_READ, MAP_PRIVATE, input_fd, 0);
+
+        if (mapped != MAP_FAILED) {
+            input.data = mapped;
+            input.size = input_stat.st_size;
+            input.is_mapped = true;
+            posix_madvise(mapped, input.size, POSIX_MADV_SEQUENTIAL);
+        }
+    }
+
+    ByteBuffer output = {NULL, 0, 0};
+    size_t max_digits = get_max_digits_in_budget();
+
+    while (1) {
+        if (input.offset == input.size || output.size >= BINARY_OUTPUT_FLUSH_SIZE) flush_byte_buffer(output_fd, &output);
+        if (!fill_binary_input(&input, 1)) break;
+
+        char operation = input.data[input.offset++];
+        bool is_x_too_large = false;
+        bool is_y_too_large = false;
+
+        BigNumber x = read_binary_input_record(&input, max_digits, &is_x_too_large);
+        BigNumber y = (x != NULL || is_x_too_large) ? read_binary_input_record(&input, max_digits, &is_y_too_large) : NULL;
+
+        if ((x == NULL && !is_x_too_large) || (y == NULL && !is_y_too_large)) {
+            if (x != NULL) free_big_number(x);
+            if (y != NULL) free_big_number(y);
+            break;
+        }
+
+        const char* error = NULL;
+        BigNumber result = (x != NULL && y != NULL) ? apply_operation(operation, x, y, &error) : NULL;
+        unsigned char status = (result != NULL) ? 0 : 1;
+
+        append_bytes(&output, &status, 1);
+        append_big_number_record(&output, result);
+
+        if (result != NULL) free_big_number(result);
+        if (x != NULL) free_big_number(x);
+        if (y != NULL) free_big_number(y);
+    }
+
+    flush_byte_buffer(output_fd, &output);
+
+    if (input.is_mapped) munmap(input.data, input.size);
+    else free(input.data);
+
+    free(output.data);
+}
+
+
+/*
+* @brief Executa o programa no modo hexadecimal.
+*
+* @details Funciona como execute_program(), com dois números e uma operação por vez,
+*          mas os números da entrada e os resultados são escritos em hexadecimal.
+*/
+
+void execute_hex_program() {
+    while (1) {
+        char* number_1 = read_input();
+
+        if (strlen(number_1) == 0) {
+            free(number_1);
+            break;
+        }
+
+        char* number_2 = read_input();
+        char* operation = read_input();
+
+        BigNumber big_num1 = create_big_number_from_hex(number_1);
+        BigNumber big_num2 = create_big_number_from_hex(number_2);
+        BigNumber result = NULL;
+        const char* error = "Entrada inválida";
+
+        if (big_num1 != NULL && big_num2 != NULL) {
+            result = apply_operation(find_operation(operation), big_num1, big_num2, &error);
+        }
+
+        if (result != NULL) {
+            char* hex = big_number_to_hex(result);
+
+            printf("%s\n", hex);
+
+            free(hex);
+            free_big_number(result);
+        }
+
+        else {
+            printf("%s\n", error);
+        }
+
+        if (big_num1 != NULL) free_big_number(big_num1);
+        if (big_num2 != NULL) free_big_number(big_num2);
+        free(number_1);
+        free(number_2);
+        free(operation);
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef wire_h
+#define wire_h
+
+#include <stddef.h>
+#include "bignumber.h"
+
+/*
+* Formato binário (todos os inteiros em little-endian):
+*
+*   Registro de número:  1 byte de sinal (0 = positivo, 1 = negativo),
+*                        4 bytes com a quantidade n de limbs,
+*                        n limbs de 4 bytes em base 10^9, do menos para o mais significativo.
+*
+*   Requisição:          1 byte com a operação (mesmos caracteres da entrada decimal),
+*                        seguido dos registros do primeiro e do segundo número.
+*
+*   Resposta:            1 byte de status (0 = sucesso, 1 = erro), seguido do registro
+*                        do resultado (vazio, com n = 0, em caso de erro).
+*/
+
+#define BINARY_READ_SIZE 65536
+#define BINARY_OUTPUT_FLUSH_SIZE (1 << 20)
+#define HEX_LIMB_BASE 65536
+#define HEX_LIMB_DIGITS 4
+#define BASE_CONVERSION_BLOCK 32
+#define BASE_CONVERSION_NTT_LIMBS 128
+
+typedef struct ByteBuffer {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} ByteBuffer;
+
+typedef struct BinaryInput {
+    int fd;
+    unsigned char *data;
+    size_t size;
+    size_t offset;
+    size_t capacity;
+    bool is_mapped;
+    bool is_finished;
+} BinaryInput;
+
+void append_bytes(ByteBuffer *buffer, const void *bytes, size_t size);
+void append_big_number_record(ByteBuffer *buffer, BigNumber x);
+BigNumber read_big_number_record(const unsigned char *data, size_t size, size_t *offset);
+
+BigNumber create_big_number_from_hex(const char *str_number);
+char* big_number_to_hex(BigNumber x);
+
+void execute_binary_program(int input_fd, int output_fd);
+void execute_hex_program();
+
+#endif